@@ -1,7 +1,12 @@
 // File: Hamna_UNIDISC.cpp
 // Single-file, fully functional UNIDISC Engine (Hamna's modules)
-// Constraints: only <iostream>, <vector>, <string>, <fstream>, <functional>, <algorithm>
-// Uses cout/cin and endl. No map, no advanced libs beyond above.
+// Standard library only, no third-party dependencies:
+//   core engine and CLI:   <iostream> <fstream> <sstream> <string> <vector> <deque>
+//                          <functional> <algorithm> <memory> <cstdint>
+//   batch query service:   <thread> <mutex> <condition_variable> <future>
+//   instrumentation:       <atomic> <chrono>
+// The interactive menu uses cout/cin; --batch [script] runs non-interactive
+// command scripts (see BatchRunner).
 
 #include <iostream>
 #include <vector>
@@ -9,23 +14,311 @@
 #include <fstream>
 #include <functional>
 #include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
 
 using namespace std;
 
+// --------------------------- Instrumentation ---------------------------
+// Scoped timers and atomic counters on the engine's public operations. Each
+// operation keeps an HDR-style log-linear latency histogram (8 sub-buckets per
+// power of two, so quantiles are within 12.5%). UNIDISC_STATS=0 compiles all
+// of it out; it defaults to on in debug builds and off when NDEBUG is set.
+#ifndef UNIDISC_STATS
+#ifdef NDEBUG
+#define UNIDISC_STATS 0
+#else
+#define UNIDISC_STATS 1
+#endif
+#endif
+
+enum StatOp {
+    OpClosurePrereq, OpClosureImplication, OpCycleCheck, OpListOrders,
+    OpInductionRecursive, OpInductionStrong, OpApplyImplications, OpRecommend,
+    OpReport, OpReportCycles, OpReportPrereqs, OpReportOverload, OpReportConflicts,
+    OpProofGenerate, OpProofSave, OpReduce, OpReduceExport, OpMonitorEnroll, OpMonitorPrereq,
+    StatOpCount
+};
+
+enum StatCounter {
+    CounterClosureRebuilds, CounterMatrixCopies, CounterMatrixCopyBytes, CounterFixedDispatches,
+    CounterFixedBuilds, StatCounterCount
+};
+
+#if UNIDISC_STATS
+class Stats {
+public:
+    static void record(StatOp op, uint64_t ns) {
+        OpStats& s = instance().ops[op];
+        s.count.fetch_add(1, memory_order_relaxed);
+        s.totalNs.fetch_add(ns, memory_order_relaxed);
+        s.buckets[bucketOf(ns)].fetch_add(1, memory_order_relaxed);
+        uint64_t prev = s.maxNs.load(memory_order_relaxed);
+        while (ns > prev && !s.maxNs.compare_exchange_weak(prev, ns, memory_order_relaxed)) {}
+    }
+
+    static void add(StatCounter c, uint64_t n) {
+        instance().counters[c].fetch_add(n, memory_order_relaxed);
+    }
+
+    static void matrixCopy(size_t n) {
+        add(CounterMatrixCopies, 1);
+        add(CounterMatrixCopyBytes, static_cast<uint64_t>(n) * n / 8);
+    }
+
+    static void reset() {
+        Stats& st = instance();
+        for (OpStats& s : st.ops) {
+            s.count = 0; s.totalNs = 0; s.maxNs = 0;
+            for (auto& b : s.buckets) b = 0;
+        }
+        for (auto& c : st.counters) c = 0;
+    }
+
+    static void print(ostream& out) {
+        static const char* const opNames[StatOpCount] = {
+            "closurePrereq", "closureImplication", "hasPrereqCycle", "listOrders",
+            "checkRecursive", "checkStrong", "applyImplications", "recommend",
+            "report", "report.cycles", "report.prereqs", "report.overload", "report.conflicts",
+            "proof.generate", "proof.save", "reducePrereq", "reduce.export", "monitor.enroll", "monitor.prereq" };
+        static const char* const counterNames[StatCounterCount] = {
+            "closure_rebuilds", "matrix_copies", "matrix_copy_bytes", "fixed_dispatches", "fixed_builds" };
+        Stats& st = instance();
+        out << "op,count,total_us,mean_ns,p50_ns,p90_ns,p99_ns,max_ns" << "\n";
+        for (int i = 0; i < StatOpCount; ++i) {
+            const OpStats& s = st.ops[i];
+            uint64_t n = s.count.load(memory_order_relaxed);
+            if (n == 0) continue;
+            uint64_t total = s.totalNs.load(memory_order_relaxed);
+            out << opNames[i] << "," << n << "," << total / 1000 << "," << total / n << ","
+                << quantile(s, 0.50) << "," << quantile(s, 0.90) << "," << quantile(s, 0.99) << ","
+                << s.maxNs.load(memory_order_relaxed) << "\n";
+        }
+        for (int i = 0; i < StatCounterCount; ++i)
+            out << counterNames[i] << "," << st.counters[i].load(memory_order_relaxed) << "\n";
+    }
+
+    // periodic dump: a background thread rewrites path with the current stats
+    // every intervalSec, even while one long command is running
+    static void configureDump(const string& path, int intervalSec) {
+        Stats& st = instance();
+        stopDump();
+        st.dumpPath = path;
+        chrono::seconds interval(intervalSec > 0 ? intervalSec : 1);
+        st.dumper = thread([&st, interval] {
+            unique_lock<mutex> lock(st.dumpMutex);
+            while (!st.dumpStop) {
+                if (!st.dumpWake.wait_for(lock, interval, [&st] { return st.dumpStop; })) dump();
+            }
+        });
+    }
+
+    // stop the dump thread, if any; the caller writes the final dump
+    static void stopDump() {
+        Stats& st = instance();
+        if (!st.dumper.joinable()) return;
+        {
+            lock_guard<mutex> lock(st.dumpMutex);
+            st.dumpStop = true;
+        }
+        st.dumpWake.notify_all();
+        st.dumper.join();
+        st.dumpStop = false;
+    }
+
+    static void dump() {
+        Stats& st = instance();
+        if (st.dumpPath.empty()) return;
+        ofstream ofs(st.dumpPath.c_str());
+        if (ofs.is_open()) print(ofs);
+    }
+
+private:
+    static const int Buckets = 512;
+
+    struct OpStats {
+        atomic<uint64_t> count{ 0 };
+        atomic<uint64_t> totalNs{ 0 };
+        atomic<uint64_t> maxNs{ 0 };
+        atomic<uint64_t> buckets[Buckets];
+        OpStats() { for (auto& b : buckets) b = 0; }
+    };
+
+    OpStats ops[StatOpCount];
+    atomic<uint64_t> counters[StatCounterCount];
+    string dumpPath;
+    thread dumper;
+    mutex dumpMutex;
+    condition_variable dumpWake;
+    bool dumpStop;
+
+    Stats() : dumpStop(false) { for (auto& c : counters) c = 0; }
+    ~Stats() { stopDump(); }
+
+    static Stats& instance() {
+        static Stats st;
+        return st;
+    }
+
+    // values below 8 get exact buckets; above, 8 linear sub-buckets per power of two
+    static int bucketOf(uint64_t v) {
+        if (v < 8) return static_cast<int>(v);
+        int e = 0;
+        for (int step = 32; step > 0; step >>= 1) if (v >> (e + step)) e += step;
+        return (e - 2) * 8 + static_cast<int>((v >> (e - 3)) & 7);
+    }
+
+    static uint64_t bucketUpper(int idx) {
+        if (idx < 8) return static_cast<uint64_t>(idx);
+        int e = idx / 8 + 2;
+        uint64_t m = static_cast<uint64_t>(idx % 8);
+        return ((8 + m + 1) << (e - 3)) - 1;
+    }
+
+    static uint64_t quantile(const OpStats& s, double q) {
+        uint64_t n = s.count.load(memory_order_relaxed);
+        // nearest rank: the smallest sample with at least q * n samples at or below it
+        double exact = q * static_cast<double>(n);
+        uint64_t rank = static_cast<uint64_t>(exact);
+        if (static_cast<double>(rank) < exact) ++rank;
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < Buckets; ++i) {
+            seen += s.buckets[i].load(memory_order_relaxed);
+            if (seen >= rank) return min(bucketUpper(i), s.maxNs.load(memory_order_relaxed));
+        }
+        return s.maxNs.load(memory_order_relaxed);
+    }
+};
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(StatOp o) : op(o), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        Stats::record(op, static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()));
+    }
+private:
+    StatOp op;
+    chrono::steady_clock::time_point start;
+};
+
+#define UNIDISC_CONCAT_(a, b) a##b
+#define UNIDISC_CONCAT(a, b) UNIDISC_CONCAT_(a, b)
+#define UNIDISC_TIME(op) ScopedTimer UNIDISC_CONCAT(unidiscTimer, __LINE__)(op)
+#define UNIDISC_COUNT(counter, n) Stats::add(counter, n)
+#define UNIDISC_MATRIX_COPY(n) Stats::matrixCopy(n)
+#else
+#define UNIDISC_TIME(op) ((void)0)
+#define UNIDISC_COUNT(counter, n) ((void)0)
+#define UNIDISC_MATRIX_COPY(n) ((void)0)
+#endif
+
+// --------------------------- StringPool ---------------------------
+// Interns strings: every distinct string is stored once, NUL-terminated, in a
+// contiguous arena and named by a small integer handle. Lookup uses an
+// open-addressing (linear probing) table of handles keyed by FNV-1a hash.
+class StringPool {
+public:
+    StringPool() : slots(16, -1) {}
+
+    // return the handle for s, adding it to the arena if it is new
+    int intern(const string& s) {
+        unsigned h = hashOf(s);
+        size_t pos = probe(s, h);
+        if (slots[pos] != -1) return slots[pos];
+        int handle = static_cast<int>(offsets.size());
+        offsets.push_back(static_cast<int>(arena.size()));
+        lengths.push_back(static_cast<int>(s.size()));
+        hashes.push_back(h);
+        arena.insert(arena.end(), s.begin(), s.end());
+        arena.push_back('\0');
+        slots[pos] = handle;
+        if (offsets.size() * 2 > slots.size()) grow();
+        return handle;
+    }
+
+    // handle of s, or -1 if it was never interned
+    int find(const string& s) const {
+        return slots[probe(s, hashOf(s))];
+    }
+
+    // pointer is valid until the next intern()
+    const char* get(int handle) const {
+        if (handle < 0 || handle >= size()) return "";
+        return &arena[offsets[handle]];
+    }
+
+    int size() const { return static_cast<int>(offsets.size()); }
+    size_t arenaBytes() const { return arena.size(); }
+
+private:
+    vector<char> arena;
+    vector<int> offsets;   // handle -> start in arena
+    vector<int> lengths;   // handle -> length without the terminator
+    vector<unsigned> hashes;
+    vector<int> slots;     // power-of-two table of handles, -1 = empty
+
+    static unsigned hashOf(const string& s) {
+        unsigned h = 2166136261u;
+        for (char ch : s) { h ^= static_cast<unsigned char>(ch); h *= 16777619u; }
+        return h;
+    }
+
+    bool equals(int handle, const string& s) const {
+        return lengths[handle] == static_cast<int>(s.size())
+            && equal(s.begin(), s.end(), arena.begin() + offsets[handle]);
+    }
+
+    // slot holding s, or the empty slot where it would go
+    size_t probe(const string& s, unsigned h) const {
+        size_t mask = slots.size() - 1;
+        size_t pos = h & mask;
+        while (slots[pos] != -1) {
+            int cand = slots[pos];
+            if (hashes[cand] == h && equals(cand, s)) break;
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    void grow() {
+        slots.assign(slots.size() * 2, -1);
+        size_t mask = slots.size() - 1;
+        for (int handle = 0; handle < size(); ++handle) {
+            size_t pos = hashes[handle] & mask;
+            while (slots[pos] != -1) pos = (pos + 1) & mask;
+            slots[pos] = handle;
+        }
+    }
+};
+
 // --------------------------- CourseManager ---------------------------
 class CourseManager {
 public:
+    // code and name are StringPool handles; resolve them with text()
     struct Course {
         int id;
-        string code;
-        string name;
+        int codeRef;
+        int nameRef;
         int credits;
-        Course(int i = -1, string c = "", string n = "", int cr = 0) : id(i), code(c), name(n), credits(cr) {}
+        Course(int i = -1, int c = -1, int n = -1, int cr = 0) : id(i), codeRef(c), nameRef(n), credits(cr) {}
     };
 
     int addCourse(const string& code, const string& name, int credits) {
         int id = static_cast<int>(courses.size());
-        courses.push_back(Course(id, code, name, credits));
+        int codeRef = strings.intern(code);
+        courses.push_back(Course(id, codeRef, strings.intern(name), credits));
+        if (static_cast<int>(idByString.size()) < strings.size()) idByString.resize(strings.size(), -1);
+        if (idByString[codeRef] == -1) idByString[codeRef] = id; // first course keeps a duplicated code
         return id;
     }
 
@@ -34,132 +327,517 @@ public:
         return &courses[id];
     }
 
+    // O(1) lookup by course code, e.g. "CS201"; -1 if unknown
+    int findByCode(const string& code) const {
+        int ref = strings.find(code);
+        if (ref < 0 || ref >= static_cast<int>(idByString.size())) return -1;
+        return idByString[ref];
+    }
+
+    const char* text(int ref) const { return strings.get(ref); }
+
     int count() const { return static_cast<int>(courses.size()); }
 
-    void listAll() const {
-        cout << "Courses:" << endl;
+    void listAll(ostream& out = cout) const {
+        out << "Courses:" << "\n";
         for (size_t i = 0; i < courses.size(); ++i) {
-            cout << courses[i].id << " | " << courses[i].code << " | " << courses[i].name
-                << " | credits: " << courses[i].credits << endl;
+            out << courses[i].id << " | " << text(courses[i].codeRef) << " | " << text(courses[i].nameRef)
+                << " | credits: " << courses[i].credits << "\n";
         }
     }
 
 private:
     vector<Course> courses;
+    StringPool strings;
+    vector<int> idByString; // string handle -> course id owning that code
+};
+
+// --------------------------- CopyOnWrite<T> ---------------------------
+// Value holder for state shared between the live engine and published
+// snapshots: copying is a reference-count bump, and edit() clones the value
+// only while another copy still holds it. Copies are made and edited on the
+// writer thread only; readers just read and release theirs, so a count of
+// one means nobody else can see the value (the fence pairs with the
+// releasing decrement in the reader's shared_ptr destructor).
+template <class T>
+class CopyOnWrite {
+public:
+    CopyOnWrite() : p(make_shared<T>()) {}
+
+    const T& get() const { return *p; }
+
+    T& edit() {
+        if (p.use_count() > 1) p = make_shared<T>(*p);
+        else atomic_thread_fence(memory_order_acquire);
+        return *p;
+    }
+
+private:
+    shared_ptr<T> p;
+};
+
+// --------------------------- CsrRows ---------------------------
+// Compressed sparse rows, split into blocks of rowsPerBlock rows. Inside a
+// block, row r is the run ids[start[r] .. start[r] + count[r]) of one shared
+// array, so scans are sequential and no row owns a heap block. Rows carry
+// slack up to cap[r]; a full row moves to the end of the array with double
+// capacity. The abandoned blocks are holes, and the array is compacted
+// (keeping every row's slack) once holes outweigh allocated rows, so both
+// growth and compaction are amortized O(1) per entry.
+// Blocks are copy-on-write, so a copied CsrRows (a published snapshot) costs
+// one pointer per block and a later edit clones only the block it touches;
+// pick fewer rows per block when rows are long (course rosters).
+// insert()/contains() keep a row sorted; append() is the unsorted O(1) path
+// for rows that never need membership tests. Do not mix them on one row.
+class CsrRows {
+public:
+    struct Row {
+        const int* first;
+        const int* last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return static_cast<int>(last - first); }
+        bool empty() const { return first == last; }
+        vector<int> toVector() const { return vector<int>(first, last); }
+    };
+
+    explicit CsrRows(int rowsPerBlock = 256) : perBlock(rowsPerBlock), nrows(0), live(0) {}
+
+    void ensureRows(int n) {
+        if (n <= nrows) return;
+        nrows = n;
+        while (static_cast<int>(blocks.size()) * perBlock < n) {
+            blocks.push_back(CopyOnWrite<Block>());
+            blocks.back().edit().setRows(perBlock);
+        }
+    }
+
+    int rows() const { return nrows; }
+    long long total() const { return live; }
+
+    Row row(int r) const {
+        Row out;
+        if (r < 0 || r >= nrows) { out.first = out.last = nullptr; return out; }
+        const Block& b = blocks[r / perBlock].get();
+        int i = r % perBlock;
+        out.first = b.ids.data() + b.start[i];
+        out.last = out.first + b.count[i];
+        return out;
+    }
+
+    // O(log k) membership test by binary search within the row
+    bool contains(int r, int v) const {
+        Row rw = row(r);
+        return binary_search(rw.begin(), rw.end(), v);
+    }
+
+    // sorted insert; false if v was already in the row
+    bool insert(int r, int v) {
+        if (r < 0) return false;
+        ensureRows(r + 1);
+        Row rw = row(r);
+        const int* pos = lower_bound(rw.begin(), rw.end(), v);
+        if (pos != rw.end() && *pos == v) return false; // no edit, so no clone
+        int at = static_cast<int>(pos - rw.begin());
+        Block& b = blocks[r / perBlock].edit();
+        int i = r % perBlock;
+        b.reserveOne(i);
+        int* first = b.ids.data() + b.start[i];
+        for (int k = b.count[i]; k > at; --k) first[k] = first[k - 1];
+        first[at] = v;
+        ++b.count[i];
+        ++live;
+        return true;
+    }
+
+    // unsorted append, no duplicate check
+    void append(int r, int v) {
+        if (r < 0) return;
+        ensureRows(r + 1);
+        Block& b = blocks[r / perBlock].edit();
+        int i = r % perBlock;
+        b.reserveOne(i);
+        b.ids[b.start[i] + b.count[i]] = v;
+        ++b.count[i];
+        ++live;
+    }
+
+private:
+    struct Block {
+        vector<int> start;
+        vector<int> count;
+        vector<int> cap;
+        vector<int> ids;
+        long long allocated; // sum of cap[]; ids.size() - allocated are holes
+
+        Block() : allocated(0) {}
+
+        void setRows(int n) {
+            start.assign(n, 0);
+            count.assign(n, 0);
+            cap.assign(n, 0);
+        }
+
+        void reserveOne(int i) {
+            if (count[i] < cap[i]) return;
+            long long holes = static_cast<long long>(ids.size()) - allocated;
+            if (holes > allocated + 64) compact();
+            int newCap = cap[i] < 2 ? 2 : cap[i] * 2;
+            int from = start[i];
+            start[i] = static_cast<int>(ids.size());
+            ids.resize(ids.size() + newCap, -1);
+            copy(ids.begin() + from, ids.begin() + from + count[i], ids.begin() + start[i]);
+            allocated += newCap - cap[i];
+            cap[i] = newCap;
+        }
+
+        // rewrite all rows back to back in row order, dropping holes but keeping slack
+        void compact() {
+            vector<int> packed(static_cast<size_t>(allocated), -1);
+            int at = 0;
+            for (int i = 0; i < static_cast<int>(start.size()); ++i) {
+                copy(ids.begin() + start[i], ids.begin() + start[i] + count[i], packed.begin() + at);
+                start[i] = at;
+                at += cap[i];
+            }
+            ids.swap(packed);
+        }
+    };
+
+    vector<CopyOnWrite<Block>> blocks;
+    int perBlock;
+    int nrows;
+    long long live;
 };
 
 // --------------------------- PeopleManager ---------------------------
 class PeopleManager {
 public:
+    // names are StringPool handles; resolve them with text()
     struct Student {
         int id;
-        string name;
-        vector<int> enrolled; // course ids
-        Student(int i = -1, string n = "") : id(i), name(n) {}
+        int nameRef;
+        Student(int i = -1, int n = -1) : id(i), nameRef(n) {}
     };
 
     struct Faculty {
         int id;
-        string name;
-        Faculty(int i = -1, string n = "") : id(i), name(n) {}
+        int nameRef;
+        Faculty(int i = -1, int n = -1) : id(i), nameRef(n) {}
     };
 
     struct Room {
         int id;
-        string name;
-        Room(int i = -1, string n = "") : id(i), name(n) {}
+        int nameRef;
+        Room(int i = -1, int n = -1) : id(i), nameRef(n) {}
     };
 
+    // student rows hold a few courses each; a roster can hold thousands of
+    // students, so roster blocks are small to keep snapshot edits cheap
+    PeopleManager() : enrollments(256), rosters(8) {}
+
     int addStudent(const string& name) {
-        int id = static_cast<int>(students.size());
-        students.push_back(Student(id, name));
+        Directory& d = dir.edit();
+        int id = static_cast<int>(d.students.size());
+        int ref = d.strings.intern(name);
+        d.students.push_back(Student(id, ref));
+        indexName(d.studentByName, ref, id);
         return id;
     }
     int addFaculty(const string& name) {
-        int id = static_cast<int>(faculties.size());
-        faculties.push_back(Faculty(id, name));
+        Directory& d = dir.edit();
+        int id = static_cast<int>(d.faculties.size());
+        int ref = d.strings.intern(name);
+        d.faculties.push_back(Faculty(id, ref));
+        indexName(d.facultyByName, ref, id);
         return id;
     }
     int addRoom(const string& name) {
-        int id = static_cast<int>(rooms.size());
-        rooms.push_back(Room(id, name));
+        Directory& d = dir.edit();
+        int id = static_cast<int>(d.rooms.size());
+        int ref = d.strings.intern(name);
+        d.rooms.push_back(Room(id, ref));
+        indexName(d.roomByName, ref, id);
         return id;
     }
 
+    // O(1) lookups by name; -1 if unknown (first entity wins on duplicate names)
+    int findStudent(const string& name) const { return lookupName(dir.get().studentByName, name); }
+    int findFaculty(const string& name) const { return lookupName(dir.get().facultyByName, name); }
+    int findRoom(const string& name) const { return lookupName(dir.get().roomByName, name); }
+
+    const char* text(int ref) const { return dir.get().strings.get(ref); }
+
+    // enrollments live in CsrRows: student -> sorted course ids, and the
+    // reverse index course -> roster of student ids in enrollment order
+    bool enroll(int studentId, int courseId) {
+        if (!getStudentConst(studentId) || courseId < 0) return false;
+        if (!enrollments.insert(studentId, courseId)) return false;
+        rosters.append(courseId, studentId);
+        return true;
+    }
+    bool isEnrolled(int studentId, int courseId) const { return enrollments.contains(studentId, courseId); }
+    CsrRows::Row coursesOf(int studentId) const { return enrollments.row(studentId); }
+    CsrRows::Row rosterOf(int courseId) const { return rosters.row(courseId); }
+    long long enrollmentCount() const { return enrollments.total(); }
+
     Student* getStudent(int id) {
-        if (id < 0 || id >= static_cast<int>(students.size())) return nullptr;
-        return &students[id];
+        if (id < 0 || id >= static_cast<int>(dir.get().students.size())) return nullptr;
+        return &dir.edit().students[id];
     }
     const Student* getStudentConst(int id) const {
+        const vector<Student>& students = dir.get().students;
         if (id < 0 || id >= static_cast<int>(students.size())) return nullptr;
         return &students[id];
     }
-    const vector<Student>& listStudents() const { return students; }
-    const vector<Faculty>& listFaculties() const { return faculties; }
-    const vector<Room>& listRooms() const { return rooms; }
+    const vector<Student>& listStudents() const { return dir.get().students; }
+    const vector<Faculty>& listFaculties() const { return dir.get().faculties; }
+    const vector<Room>& listRooms() const { return dir.get().rooms; }
 
     Faculty* getFaculty(int id) {
+        if (id < 0 || id >= static_cast<int>(dir.get().faculties.size())) return nullptr;
+        return &dir.edit().faculties[id];
+    }
+    const Faculty* getFaculty(int id) const {
+        const vector<Faculty>& faculties = dir.get().faculties;
         if (id < 0 || id >= static_cast<int>(faculties.size())) return nullptr;
         return &faculties[id];
     }
     Room* getRoom(int id) {
+        if (id < 0 || id >= static_cast<int>(dir.get().rooms.size())) return nullptr;
+        return &dir.edit().rooms[id];
+    }
+    const Room* getRoom(int id) const {
+        const vector<Room>& rooms = dir.get().rooms;
         if (id < 0 || id >= static_cast<int>(rooms.size())) return nullptr;
         return &rooms[id];
     }
 
-    void listAllStudents() const {
-        cout << "Students:" << endl;
+    void listAllStudents(ostream& out = cout) const {
+        const vector<Student>& students = dir.get().students;
+        out << "Students:" << "\n";
         for (size_t i = 0; i < students.size(); ++i) {
-            cout << students[i].id << " | " << students[i].name << " | enrolled: ";
-            for (size_t j = 0; j < students[i].enrolled.size(); ++j) {
-                cout << students[i].enrolled[j];
-                if (j + 1 < students[i].enrolled.size()) cout << ",";
+            out << students[i].id << " | " << text(students[i].nameRef) << " | enrolled: ";
+            CsrRows::Row row = coursesOf(students[i].id);
+            for (const int* it = row.begin(); it != row.end(); ++it) {
+                out << *it;
+                if (it + 1 != row.end()) out << ",";
             }
-            cout << endl;
+            out << "\n";
         }
     }
 
-    void listAllFaculties() const {
-        cout << "Faculty:" << endl;
+    void listAllFaculties(ostream& out = cout) const {
+        const vector<Faculty>& faculties = dir.get().faculties;
+        out << "Faculty:" << "\n";
         for (size_t i = 0; i < faculties.size(); ++i) {
-            cout << faculties[i].id << " | " << faculties[i].name << endl;
+            out << faculties[i].id << " | " << text(faculties[i].nameRef) << "\n";
         }
     }
 
-    void listAllRooms() const {
-        cout << "Rooms:" << endl;
+    void listAllRooms(ostream& out = cout) const {
+        const vector<Room>& rooms = dir.get().rooms;
+        out << "Rooms:" << "\n";
         for (size_t i = 0; i < rooms.size(); ++i) {
-            cout << rooms[i].id << " | " << rooms[i].name << endl;
+            out << rooms[i].id << " | " << text(rooms[i].nameRef) << "\n";
+        }
+    }
+
+private:
+    // everything but enrollments; changes only when people are added
+    struct Directory {
+        vector<Student> students;
+        vector<Faculty> faculties;
+        vector<Room> rooms;
+        StringPool strings;
+        vector<int> studentByName; // string handle -> id, per entity kind
+        vector<int> facultyByName;
+        vector<int> roomByName;
+    };
+
+    // copy-on-write parts: a copy (published snapshot) shares them, and an
+    // enrollment clones only the CsrRows blocks of its student and course
+    CopyOnWrite<Directory> dir;
+    CsrRows enrollments;
+    CsrRows rosters;
+
+    void indexName(vector<int>& index, int ref, int id) {
+        if (static_cast<int>(index.size()) <= ref) index.resize(ref + 1, -1);
+        if (index[ref] == -1) index[ref] = id;
+    }
+    int lookupName(const vector<int>& index, const string& name) const {
+        int ref = dir.get().strings.find(name);
+        if (ref < 0 || ref >= static_cast<int>(index.size())) return -1;
+        return index[ref];
+    }
+};
+
+// --------------------------- FixedRelations<W> ---------------------------
+// Fixed-capacity relation engine for small catalogs (up to 64 * W courses).
+// Every row is W machine words, so closure, cycle, eligibility and implication
+// steps are short fixed-length word loops the compiler fully unrolls. Rows are
+// plain word arrays rather than std::array so all members stay constexpr under
+// C++14. Prerequisites are stored by dependent course (req[b] has bit a when
+// a -> b) so an eligibility check is one masked compare; implications are
+// stored forward (impl[a] has bit b when a -> b).
+template <int W>
+class FixedRelations {
+public:
+    static constexpr int Capacity = 64 * W;
+
+    struct Bits {
+        uint64_t w[W];
+        constexpr Bits() : w{} {}
+        constexpr void set(int i) { w[i >> 6] |= uint64_t(1) << (i & 63); }
+        constexpr bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+        constexpr void merge(const Bits& o) { for (int k = 0; k < W; ++k) w[k] |= o.w[k]; }
+        constexpr bool subsetOf(const Bits& o) const {
+            for (int k = 0; k < W; ++k) if (w[k] & ~o.w[k]) return false;
+            return true;
+        }
+    };
+
+    constexpr FixedRelations() : n(0), req{}, impl{} {}
+
+    constexpr int size() const { return n; }
+    constexpr void setSize(int count) { n = count < Capacity ? count : Capacity; }
+    constexpr void addPrereq(int a, int b) { if (valid(a) && valid(b)) req[b].set(a); }
+    constexpr void addImplication(int a, int b) { if (valid(a) && valid(b)) impl[a].set(b); }
+    constexpr bool getPrereq(int a, int b) const { return valid(a) && valid(b) && req[b].test(a); }
+
+    // Warshall's algorithm on bit rows, in place for both relations
+    constexpr void close() {
+        for (int k = 0; k < n; ++k) {
+            for (int i = 0; i < n; ++i) {
+                if (req[i].test(k)) req[i].merge(req[k]);
+                if (impl[i].test(k)) impl[i].merge(impl[k]);
+            }
+        }
+    }
+
+    // the following require close() to have been called
+    constexpr bool hasPrereqCycle() const {
+        for (int i = 0; i < n; ++i) if (req[i].test(i)) return true;
+        return false;
+    }
+    constexpr const Bits& prereqsOf(int c) const { return req[c]; }
+    constexpr bool eligible(int c, const Bits& completed) const { return valid(c) && req[c].subsetOf(completed); }
+    constexpr Bits applyImplications(const Bits& facts) const {
+        Bits out = facts;
+        for (int i = 0; i < n; ++i) if (facts.test(i)) out.merge(impl[i]);
+        return out;
+    }
+
+    // Matrix: anything with size() and m[a][b], e.g. Relations' RowSharedMatrix
+    template <class Matrix>
+    void load(const Matrix& prereq, const Matrix& implication) {
+        setSize(static_cast<int>(prereq.size()));
+        for (int a = 0; a < n; ++a) {
+            for (int b = 0; b < n; ++b) {
+                if (prereq[a][b]) req[b].set(a);
+                if (implication[a][b]) impl[a].set(b);
+            }
         }
     }
 
+    Bits toBits(const vector<bool>& v) const {
+        Bits out;
+        int m = static_cast<int>(v.size()) < n ? static_cast<int>(v.size()) : n;
+        for (int i = 0; i < m; ++i) if (v[i]) out.set(i);
+        return out;
+    }
+
+private:
+    int n;
+    Bits req[Capacity];
+    Bits impl[Capacity];
+
+    constexpr bool valid(int x) const { return x >= 0 && x < n; }
+};
+
+// compile-time self check: 0 -> 1 -> 2 closes to 0 -> 2 without a cycle
+constexpr bool fixedRelationsSelfCheck() {
+    FixedRelations<1> r;
+    r.setSize(3);
+    r.addPrereq(0, 1);
+    r.addPrereq(1, 2);
+    r.close();
+    return r.getPrereq(0, 2) && !r.hasPrereqCycle();
+}
+static_assert(fixedRelationsSelfCheck(), "FixedRelations closure must be constexpr-evaluable");
+
+// --------------------------- RowSharedMatrix ---------------------------
+// n x n bool matrix with copy-on-write rows: a copy (a published snapshot)
+// shares every row, and set() clones only the row it changes.
+class RowSharedMatrix {
+public:
+    int size() const { return static_cast<int>(rows.size()); }
+    const vector<bool>& operator[](int a) const { return rows[a].get(); }
+    void set(int a, int b, bool v) { rows[a].edit()[b] = v; }
+
+    // grow to n x n, keeping existing entries
+    void resize(int n) {
+        int old = size();
+        if (n <= old) return;
+        for (auto& row : rows) row.edit().resize(n, false);
+        rows.resize(n);
+        for (int a = old; a < n; ++a) rows[a].edit().assign(n, false);
+    }
+
+    vector<vector<bool>> dense() const {
+        vector<vector<bool>> out;
+        out.reserve(rows.size());
+        for (const auto& row : rows) out.push_back(row.get());
+        return out;
+    }
+
 private:
-    vector<Student> students;
-    vector<Faculty> faculties;
-    vector<Room> rooms;
+    vector<CopyOnWrite<vector<bool>>> rows;
 };
 
 // --------------------------- Relations ---------------------------
 // relations over course ids: prereq and implication
+// The closed FixedRelations for small catalogs is cached per size class and
+// dropped by every mutation. Const readers on different threads may fill the
+// cache concurrently, so the slots are only touched through atomic_load and
+// atomic_store; a racing duplicate build is harmless.
 class Relations {
 public:
     Relations() {}
+    Relations(const Relations& o)
+        : prereq(o.prereq), implication(o.implication),
+          fixed1(atomic_load(&o.fixed1)), fixed2(atomic_load(&o.fixed2)), fixed4(atomic_load(&o.fixed4)) {}
+    Relations& operator=(const Relations& o) {
+        if (this == &o) return *this;
+        prereq = o.prereq;
+        implication = o.implication;
+        atomic_store(&fixed1, atomic_load(&o.fixed1));
+        atomic_store(&fixed2, atomic_load(&o.fixed2));
+        atomic_store(&fixed4, atomic_load(&o.fixed4));
+        return *this;
+    }
 
+    // grow both matrices to n x n, keeping existing edges
     void ensureSize(int n) {
         if (n <= 0) return;
         int old = static_cast<int>(prereq.size());
-        if (n == old) return;
-        prereq.assign(n, vector<bool>(n, false));
-        implication.assign(n, vector<bool>(n, false));
+        if (n <= old) return;
+        dropFixed();
+        prereq.resize(n);
+        implication.resize(n);
     }
 
     void addPrereq(int a, int b) {
         if (!validIndexForEnsure(a) || !validIndexForEnsure(b)) return;
-        prereq[a][b] = true;
+        if (prereq[a][b]) return;
+        prereq.set(a, b, true);
+        dropFixed();
     }
     void addImplication(int a, int b) {
         if (!validIndexForEnsure(a) || !validIndexForEnsure(b)) return;
-        implication[a][b] = true;
+        if (implication[a][b]) return;
+        implication.set(a, b, true);
+        dropFixed();
     }
 
     bool getPrereq(int a, int b) const {
@@ -171,8 +849,11 @@ public:
 
     // compute transitive closure of prereq
     vector<vector<bool>> closurePrereq() const {
+        UNIDISC_TIME(OpClosurePrereq);
+        UNIDISC_COUNT(CounterClosureRebuilds, 1);
         int n = size();
-        vector<vector<bool>> c = prereq;
+        UNIDISC_MATRIX_COPY(n);
+        vector<vector<bool>> c = prereq.dense();
         for (int k = 0; k < n; ++k) {
             for (int i = 0; i < n; ++i) if (c[i][k]) {
                 for (int j = 0; j < n; ++j) if (c[k][j]) c[i][j] = true;
@@ -183,8 +864,11 @@ public:
 
     // compute closure of implication
     vector<vector<bool>> closureImplication() const {
+        UNIDISC_TIME(OpClosureImplication);
+        UNIDISC_COUNT(CounterClosureRebuilds, 1);
         int n = size();
-        vector<vector<bool>> c = implication;
+        UNIDISC_MATRIX_COPY(n);
+        vector<vector<bool>> c = implication.dense();
         for (int k = 0; k < n; ++k) {
             for (int i = 0; i < n; ++i) if (c[i][k]) {
                 for (int j = 0; j < n; ++j) if (c[k][j]) c[i][j] = true;
@@ -193,23 +877,149 @@ public:
         return c;
     }
 
+    // run f on the cached closed FixedRelations, using the smallest
+    // specialization that fits (64/128/256 courses); false when the catalog
+    // is too large
+    template <class F>
+    bool withFixed(F f) const {
+        int n = size();
+        if (n <= FixedRelations<1>::Capacity) return runFixed<1>(f);
+        if (n <= FixedRelations<2>::Capacity) return runFixed<2>(f);
+        if (n <= FixedRelations<4>::Capacity) return runFixed<4>(f);
+        return false;
+    }
+
     bool hasPrereqCycle() const {
+        UNIDISC_TIME(OpCycleCheck);
+        bool cyclic = false;
+        if (withFixed([&](const auto& fr) { cyclic = fr.hasPrereqCycle(); })) return cyclic;
         vector<vector<bool>> c = closurePrereq();
         int n = size();
         for (int i = 0; i < n; ++i) if (c[i][i]) return true;
         return false;
     }
 
-    const vector<vector<bool>>& getPrereqMatrix() const { return prereq; }
-    const vector<vector<bool>>& getImplicationMatrix() const { return implication; }
+    vector<vector<bool>> getPrereqMatrix() const { return prereq.dense(); }
+    vector<vector<bool>> getImplicationMatrix() const { return implication.dense(); }
+
+    void removePrereq(int a, int b) {
+        if (!validIndex(a) || !validIndex(b) || !prereq[a][b]) return;
+        prereq.set(a, b, false);
+        dropFixed();
+    }
+
+    // transitive reduction of the prerequisite DAG: minimal gets the smallest
+    // edge set with the same closure, redundant the edges implied by others,
+    // both sorted by (a, b). Dense graphs use bit-row closure, sparse ones a
+    // DFS per course. Returns false (and leaves both empty) on a cycle, where
+    // the reduction is not unique; Kahn's order finds cycles in O(n + m).
+    bool reducePrereq(vector<pair<int, int>>& minimal, vector<pair<int, int>>& redundant) const {
+        UNIDISC_TIME(OpReduce);
+        minimal.clear();
+        redundant.clear();
+        int n = size();
+        vector<vector<int>> succ(n);
+        long long m = 0;
+        for (int a = 0; a < n; ++a)
+            for (int b = 0; b < n; ++b) if (prereq[a][b]) { succ[a].push_back(b); ++m; }
+        vector<int> order = topoOrder(succ);
+        if (static_cast<int>(order.size()) < n) return false;
+        // average out-degree at least one word per row: word-parallel rows win
+        bool dense = m >= static_cast<long long>(n) * (n / 64 + 1);
+        vector<bool> covered(n, false);
+        if (dense) {
+            vector<vector<uint64_t>> below = descendantRows(succ, order);
+            int words = (n + 63) / 64;
+            vector<uint64_t> cover(words);
+            for (int a = 0; a < n; ++a) {
+                fill(cover.begin(), cover.end(), 0);
+                for (int c : succ[a]) for (int k = 0; k < words; ++k) cover[k] |= below[c][k];
+                for (int b : succ[a]) splitEdge(a, b, (cover[b >> 6] >> (b & 63)) & 1, minimal, redundant);
+            }
+        }
+        else {
+            vector<int> seen(n, -1), stack;
+            for (int a = 0; a < n; ++a) {
+                // everything reachable from a by a path of two or more edges
+                for (int c : succ[a]) for (int d : succ[c]) if (seen[d] != a) { seen[d] = a; stack.push_back(d); }
+                while (!stack.empty()) {
+                    int v = stack.back(); stack.pop_back();
+                    for (int w : succ[v]) if (seen[w] != a) { seen[w] = a; stack.push_back(w); }
+                }
+                for (int b : succ[a]) splitEdge(a, b, seen[b] == a, minimal, redundant);
+            }
+        }
+        return true;
+    }
 
 private:
-    vector<vector<bool>> prereq;
-    vector<vector<bool>> implication;
+    RowSharedMatrix prereq;      // copies share unchanged rows with the original
+    RowSharedMatrix implication;
+    mutable shared_ptr<const FixedRelations<1>> fixed1;
+    mutable shared_ptr<const FixedRelations<2>> fixed2;
+    mutable shared_ptr<const FixedRelations<4>> fixed4;
+
+    // cache slot for FixedRelations<W>, picked by overload on a null tag
+    shared_ptr<const FixedRelations<1>>& fixedSlot(const FixedRelations<1>*) const { return fixed1; }
+    shared_ptr<const FixedRelations<2>>& fixedSlot(const FixedRelations<2>*) const { return fixed2; }
+    shared_ptr<const FixedRelations<4>>& fixedSlot(const FixedRelations<4>*) const { return fixed4; }
+
+    void dropFixed() {
+        atomic_store(&fixed1, shared_ptr<const FixedRelations<1>>());
+        atomic_store(&fixed2, shared_ptr<const FixedRelations<2>>());
+        atomic_store(&fixed4, shared_ptr<const FixedRelations<4>>());
+    }
 
     bool validIndex(int x) const {
         return x >= 0 && x < static_cast<int>(prereq.size());
     }
+
+    static void splitEdge(int a, int b, bool implied, vector<pair<int, int>>& minimal, vector<pair<int, int>>& redundant) {
+        (implied ? redundant : minimal).push_back(make_pair(a, b));
+    }
+
+    // Kahn's algorithm; courses on or behind a cycle are left out of the order
+    static vector<int> topoOrder(const vector<vector<int>>& succ) {
+        int n = static_cast<int>(succ.size());
+        vector<int> indeg(n, 0), order;
+        for (int a = 0; a < n; ++a) for (int b : succ[a]) ++indeg[b];
+        for (int a = 0; a < n; ++a) if (indeg[a] == 0) order.push_back(a);
+        for (size_t i = 0; i < order.size(); ++i)
+            for (int b : succ[order[i]]) if (--indeg[b] == 0) order.push_back(b);
+        return order;
+    }
+
+    // bit rows of proper descendants per course, built in reverse topological order
+    static vector<vector<uint64_t>> descendantRows(const vector<vector<int>>& succ, const vector<int>& order) {
+        int n = static_cast<int>(succ.size());
+        int words = (n + 63) / 64;
+        vector<vector<uint64_t>> below(n, vector<uint64_t>(words, 0));
+        for (int i = static_cast<int>(order.size()) - 1; i >= 0; --i) {
+            int a = order[i];
+            for (int b : succ[a]) {
+                below[a][b >> 6] |= uint64_t(1) << (b & 63);
+                for (int k = 0; k < words; ++k) below[a][k] |= below[b][k];
+            }
+        }
+        return below;
+    }
+
+    template <int W, class F>
+    bool runFixed(F& f) const {
+        UNIDISC_COUNT(CounterFixedDispatches, 1);
+        shared_ptr<const FixedRelations<W>>& slot = fixedSlot(static_cast<const FixedRelations<W>*>(nullptr));
+        shared_ptr<const FixedRelations<W>> fr = atomic_load(&slot);
+        if (!fr) {
+            UNIDISC_COUNT(CounterFixedBuilds, 1);
+            shared_ptr<FixedRelations<W>> built = make_shared<FixedRelations<W>>();
+            built->load(prereq, implication);
+            built->close();
+            fr = built;
+            atomic_store(&slot, fr);
+        }
+        f(*fr);
+        return true;
+    }
     bool validIndexForEnsure(int x) {
         if (x < 0) return false;
         if (x >= static_cast<int>(prereq.size())) {
@@ -227,9 +1037,11 @@ public:
 
     // list up to limit topological orders for n courses (0..n-1)
     vector<vector<int>> listOrders(int n, int limit = 200) const {
+        UNIDISC_TIME(OpListOrders);
         vector<vector<int>> orders;
         if (n <= 0) return orders;
         // adjacency from relations.prereq
+        UNIDISC_MATRIX_COPY(relations.size());
         vector<vector<bool>> adj = relations.getPrereqMatrix();
         if (static_cast<int>(adj.size()) < n) adj.assign(n, vector<bool>(n, false));
         vector<int> order;
@@ -273,8 +1085,10 @@ public:
 
     // recursive check: verify prerequisites using DFS-like recursion.
     bool checkRecursive(int courseId, const vector<bool>& completed) const {
+        UNIDISC_TIME(OpInductionRecursive);
         int n = relations.size();
         if (courseId < 0 || courseId >= n) return false;
+        UNIDISC_MATRIX_COPY(n);
         vector<vector<bool>> adj = relations.getPrereqMatrix();
         vector<int> visited(n, 0);
         function<bool(int)> dfs = [&](int v)->bool {
@@ -292,8 +1106,11 @@ public:
 
     // strong induction: check all indirect prerequisites are in completed
     bool checkStrong(int courseId, const vector<bool>& completed) const {
+        UNIDISC_TIME(OpInductionStrong);
         int n = relations.size();
         if (courseId < 0 || courseId >= n) return false;
+        bool ok = false;
+        if (relations.withFixed([&](const auto& fr) { ok = fr.eligible(courseId, fr.toBits(completed)); })) return ok;
         vector<vector<bool>> cl = relations.closurePrereq();
         for (int i = 0; i < n; ++i) if (cl[i][courseId]) {
             if (!(i >= 0 && i < static_cast<int>(completed.size()))) return false;
@@ -323,8 +1140,14 @@ public:
 
     // apply implication closure to an initial facts vector<bool>
     vector<bool> applyImplications(vector<bool> facts) const {
+        UNIDISC_TIME(OpApplyImplications);
         int n = relations.size();
         if (static_cast<int>(facts.size()) < n) facts.resize(n, false);
+        bool fast = relations.withFixed([&](const auto& fr) {
+            auto after = fr.applyImplications(fr.toBits(facts));
+            for (int i = 0; i < n; ++i) if (after.test(i)) facts[i] = true;
+        });
+        if (fast) return facts;
         vector<vector<bool>> impl = relations.closureImplication();
         bool changed = true;
         while (changed) {
@@ -415,66 +1238,72 @@ public:
 // --------------------------- Consistency ---------------------------
 class Consistency {
 public:
-    Consistency(const Relations& r, const CourseManager& cm, PeopleManager& pm,
+    Consistency(const Relations& r, const CourseManager& cm, const PeopleManager& pm,
         const vector<int>& courseToFaculty, const vector<int>& courseToRoom)
         : relations(r), courseMgr(cm), peopleMgr(pm),
         cToF(courseToFaculty), cToR(courseToRoom) {
     }
 
+    static const int OverloadLimit = 6; // more enrolled courses than this is flagged
+
     // run various checks and print results
-    void runAllChecks() const {
-        cout << "=== Consistency Report ===" << endl;
-        checkPrereqCycles();
-        checkStudentsPrereqs();
-        checkStudentOverload();
-        checkFacultyRoomConflicts();
-        cout << "=== End Report ===" << endl;
+    void runAllChecks(ostream& out = cout) const {
+        UNIDISC_TIME(OpReport);
+        out << "=== Consistency Report ===" << "\n";
+        checkPrereqCycles(out);
+        checkStudentsPrereqs(out);
+        checkStudentOverload(out);
+        checkFacultyRoomConflicts(out);
+        out << "=== End Report ===" << "\n";
     }
 
 private:
     const Relations& relations;
     const CourseManager& courseMgr;
-    PeopleManager& peopleMgr;
+    const PeopleManager& peopleMgr;
     const vector<int>& cToF;
     const vector<int>& cToR;
 
-    void checkPrereqCycles() const {
-        if (relations.hasPrereqCycle()) cout << "Error: prerequisite cycles detected." << endl;
-        else cout << "Prerequisite relation appears acyclic." << endl;
+    void checkPrereqCycles(ostream& out) const {
+        UNIDISC_TIME(OpReportCycles);
+        if (relations.hasPrereqCycle()) out << "Error: prerequisite cycles detected." << "\n";
+        else out << "Prerequisite relation appears acyclic." << "\n";
     }
 
-    void checkStudentsPrereqs() const {
+    void checkStudentsPrereqs(ostream& out) const {
+        UNIDISC_TIME(OpReportPrereqs);
         vector<vector<bool>> cl = relations.closurePrereq();
         int n = relations.size();
         const vector<PeopleManager::Student>& students = peopleMgr.listStudents();
         for (const auto& s : students) {
-            vector<bool> enrolled(n, false);
-            for (int c : s.enrolled) if (c >= 0 && c < n) enrolled[c] = true;
-            for (int c : s.enrolled) {
+            for (int c : peopleMgr.coursesOf(s.id)) {
                 if (c < 0 || c >= n) continue;
                 for (int p = 0; p < n; ++p) if (cl[p][c]) {
-                    if (!enrolled[p]) {
+                    if (!peopleMgr.isEnrolled(s.id, p)) {
                         const CourseManager::Course* pc = courseMgr.getCourse(p);
                         const CourseManager::Course* cc = courseMgr.getCourse(c);
-                        string pname = pc ? pc->code : ("C#" + to_string(p));
-                        string cname = cc ? cc->code : ("C#" + to_string(c));
-                        cout << "Student " << s.name << " missing prereq " << pname << " for " << cname << "." << endl;
+                        string pname = pc ? courseMgr.text(pc->codeRef) : ("C#" + to_string(p));
+                        string cname = cc ? courseMgr.text(cc->codeRef) : ("C#" + to_string(c));
+                        out << "Student " << peopleMgr.text(s.nameRef) << " missing prereq " << pname << " for " << cname << "." << "\n";
                     }
                 }
             }
         }
     }
 
-    void checkStudentOverload() const {
+    void checkStudentOverload(ostream& out) const {
+        UNIDISC_TIME(OpReportOverload);
         const vector<PeopleManager::Student>& students = peopleMgr.listStudents();
         for (const auto& s : students) {
-            if (static_cast<int>(s.enrolled.size()) > 6) {
-                cout << "Warning: student " << s.name << " enrolled in " << s.enrolled.size() << " courses (possible overload)." << endl;
+            int k = peopleMgr.coursesOf(s.id).size();
+            if (k > OverloadLimit) {
+                out << "Warning: student " << peopleMgr.text(s.nameRef) << " enrolled in " << k << " courses (possible overload)." << "\n";
             }
         }
     }
 
-    void checkFacultyRoomConflicts() const {
+    void checkFacultyRoomConflicts(ostream& out) const {
+        UNIDISC_TIME(OpReportConflicts);
         int n = courseMgr.count();
         for (int i = 0; i < n; ++i) {
             for (int j = i + 1; j < n; ++j) {
@@ -485,28 +1314,243 @@ private:
                 if (f1 != -1 && f1 == f2 && r1 != -1 && r1 == r2) {
                     const PeopleManager::Faculty* fa = peopleMgr.getFaculty(f1);
                     const PeopleManager::Room* ro = peopleMgr.getRoom(r1);
-                    cout << "Conflict: Faculty " << (fa ? fa->name : ("F#" + to_string(f1)))
-                        << " assigned to multiple courses in room " << (ro ? ro->name : ("R#" + to_string(r1))) << "." << endl;
+                    out << "Conflict: Faculty " << (fa ? string(peopleMgr.text(fa->nameRef)) : ("F#" + to_string(f1)))
+                        << " assigned to multiple courses in room " << (ro ? string(peopleMgr.text(ro->nameRef)) : ("R#" + to_string(r1))) << "." << "\n";
                 }
             }
         }
     }
 };
 
+// --------------------------- Incremental Consistency ---------------------------
+// Keeps the live set of violations up to date from mutation hooks instead of
+// re-running every check. Each hook re-evaluates only what the change can
+// affect: one student for an enrollment, the rosters of courses that gained
+// indirect prerequisites for a new edge, one (faculty, room) bucket for an
+// assignment. The prerequisite closure is maintained incrementally as well.
+class ConsistencyMonitor {
+public:
+    ConsistencyMonitor(const Relations& r, const CourseManager& cm, const PeopleManager& pm,
+        const vector<int>& courseToFaculty, const vector<int>& courseToRoom)
+        : relations(r), courseMgr(cm), peopleMgr(pm), cToF(courseToFaculty), cToR(courseToRoom), cycle(false) {
+        rebuild();
+    }
+
+    // full recomputation from the current state
+    void rebuild() {
+        cl = relations.closurePrereq();
+        int n = static_cast<int>(cl.size());
+        preds.assign(n, vector<int>());
+        for (int p = 0; p < n; ++p)
+            for (int c = 0; c < n; ++c) if (cl[p][c]) preds[c].push_back(p);
+        cycle = false;
+        for (int i = 0; i < n; ++i) if (cl[i][i]) cycle = true;
+        missing.assign(peopleMgr.listStudents().size(), vector<pair<int, int>>());
+        overloaded.assign(peopleMgr.listStudents().size(), false);
+        for (const auto& s : peopleMgr.listStudents()) recheckStudent(s.id, nullptr);
+        courseKey.clear();
+        buckets.clear();
+        for (int c = 0; c < courseMgr.count(); ++c) onAssign(c, nullptr);
+    }
+
+    // hooks: call after the mutation has been applied to the live state; any
+    // violation the change raises is appended to raised (if given)
+    // only course c is new: its missing prereqs are added, and entries that
+    // c itself satisfied are dropped; O(|preds[c]| log k + |missing[s]|)
+    void onEnroll(int s, int c, vector<string>* raised = nullptr) {
+        UNIDISC_TIME(OpMonitorEnroll);
+        if (!peopleMgr.getStudentConst(s) || c < 0) return;
+        growStudents(s + 1);
+        vector<pair<int, int>>& m = missing[s];
+        auto sat = equal_range(m.begin(), m.end(), make_pair(c, 0),
+            [](const pair<int, int>& x, const pair<int, int>& y) { return x.first < y.first; });
+        m.erase(sat.first, sat.second);
+        if (c < static_cast<int>(preds.size())) {
+            for (int p : preds[c]) {
+                if (peopleMgr.isEnrolled(s, p)) continue;
+                pair<int, int> pc(p, c);
+                m.insert(lower_bound(m.begin(), m.end(), pc), pc);
+                if (raised) raised->push_back(missingText(s, p, c));
+            }
+        }
+        checkOverload(s, raised);
+    }
+
+    void onPrereq(int a, int b, vector<string>* raised = nullptr) {
+        UNIDISC_TIME(OpMonitorPrereq);
+        if (a < 0 || b < 0) return;
+        growClosure(max(a, b) + 1);
+        if (cl[a][b]) return;
+        int n = static_cast<int>(cl.size());
+        vector<int> sources, targets;
+        for (int x = 0; x < n; ++x) if (x == a || cl[x][a]) sources.push_back(x);
+        for (int y = 0; y < n; ++y) if (y == b || cl[b][y]) targets.push_back(y);
+        vector<int> changed;
+        for (int y : targets) {
+            size_t had = preds[y].size();
+            for (int x : sources) if (!cl[x][y]) { cl[x][y] = true; preds[y].push_back(x); }
+            if (preds[y].size() == had) continue;
+            inplace_merge(preds[y].begin(), preds[y].begin() + had, preds[y].end());
+            changed.push_back(y);
+        }
+        if (!cycle && cl[b][b]) {
+            cycle = true;
+            if (raised) raised->push_back("Error: prerequisite cycles detected.");
+        }
+        vector<int> students;
+        for (int y : changed) for (int s : peopleMgr.rosterOf(y)) students.push_back(s);
+        sort(students.begin(), students.end());
+        students.erase(unique(students.begin(), students.end()), students.end());
+        for (int s : students) recheckStudent(s, raised);
+    }
+
+    // course c's faculty or room changed
+    void onAssign(int c, vector<string>* raised = nullptr) {
+        if (c < 0) return;
+        if (static_cast<int>(courseKey.size()) <= c) courseKey.resize(c + 1, -1);
+        int f = c < static_cast<int>(cToF.size()) ? cToF[c] : -1;
+        int r = c < static_cast<int>(cToR.size()) ? cToR[c] : -1;
+        long long key = (f != -1 && r != -1) ? (static_cast<long long>(f) << 32) | static_cast<unsigned>(r) : -1;
+        if (key == courseKey[c]) return;
+        if (courseKey[c] != -1) --bucket(courseKey[c]);
+        courseKey[c] = key;
+        if (key != -1 && ++bucket(key) == 2 && raised) raised->push_back(conflictText(key));
+    }
+
+    int outstanding() const {
+        int total = cycle ? 1 : 0;
+        for (const auto& m : missing) total += static_cast<int>(m.size());
+        for (bool o : overloaded) if (o) ++total;
+        for (const auto& b : buckets) if (b.second >= 2) ++total;
+        return total;
+    }
+
+    void print(ostream& out) const {
+        out << "=== Outstanding Violations ===" << "\n";
+        if (cycle) out << "Error: prerequisite cycles detected." << "\n";
+        for (int s = 0; s < static_cast<int>(missing.size()); ++s)
+            for (const auto& pc : missing[s]) out << missingText(s, pc.first, pc.second) << "\n";
+        for (int s = 0; s < static_cast<int>(overloaded.size()); ++s)
+            if (overloaded[s]) out << overloadText(s) << "\n";
+        for (const auto& b : buckets) if (b.second >= 2) out << conflictText(b.first) << "\n";
+        out << "Total: " << outstanding() << "\n";
+    }
+
+private:
+    const Relations& relations;
+    const CourseManager& courseMgr;
+    const PeopleManager& peopleMgr;
+    const vector<int>& cToF;
+    const vector<int>& cToR;
+
+    vector<vector<bool>> cl;                  // prereq closure
+    vector<vector<int>> preds;                // per course: sorted p with cl[p][c]
+    bool cycle;
+    vector<vector<pair<int, int>>> missing;   // per student: sorted (prereq, course)
+    vector<bool> overloaded;
+    vector<long long> courseKey;              // course -> (faculty << 32 | room), -1 if unassigned
+    vector<pair<long long, int>> buckets;     // sorted (faculty, room) key -> course count
+
+    void growClosure(int n) {
+        int old = static_cast<int>(cl.size());
+        if (n <= old) return;
+        for (auto& row : cl) row.resize(n, false);
+        cl.resize(n, vector<bool>(n, false));
+        preds.resize(n);
+    }
+
+    void growStudents(int n) {
+        if (static_cast<int>(missing.size()) >= n) return;
+        missing.resize(n);
+        overloaded.resize(n, false);
+    }
+
+    void checkOverload(int s, vector<string>* raised) {
+        bool over = peopleMgr.coursesOf(s).size() > Consistency::OverloadLimit;
+        if (over && !overloaded[s] && raised) raised->push_back(overloadText(s));
+        overloaded[s] = over;
+    }
+
+    int& bucket(long long key) {
+        auto it = lower_bound(buckets.begin(), buckets.end(), make_pair(key, 0),
+            [](const pair<long long, int>& x, const pair<long long, int>& y) { return x.first < y.first; });
+        if (it == buckets.end() || it->first != key) it = buckets.insert(it, make_pair(key, 0));
+        return it->second;
+    }
+
+    void recheckStudent(int s, vector<string>* raised) {
+        if (!peopleMgr.getStudentConst(s)) return;
+        growStudents(s + 1);
+        int n = static_cast<int>(preds.size());
+        vector<pair<int, int>> now;
+        for (int c : peopleMgr.coursesOf(s)) {
+            if (c >= n) continue;
+            for (int p : preds[c])
+                if (!peopleMgr.isEnrolled(s, p)) now.push_back(make_pair(p, c));
+        }
+        sort(now.begin(), now.end());
+        if (raised) {
+            for (const auto& pc : now)
+                if (!binary_search(missing[s].begin(), missing[s].end(), pc)) raised->push_back(missingText(s, pc.first, pc.second));
+        }
+        missing[s].swap(now);
+        checkOverload(s, raised);
+    }
+
+    string courseCode(int c) const {
+        const CourseManager::Course* cp = courseMgr.getCourse(c);
+        return cp ? courseMgr.text(cp->codeRef) : ("C#" + to_string(c));
+    }
+
+    string missingText(int s, int p, int c) const {
+        return string("Student ") + peopleMgr.text(peopleMgr.getStudentConst(s)->nameRef)
+            + " missing prereq " + courseCode(p) + " for " + courseCode(c) + ".";
+    }
+
+    string overloadText(int s) const {
+        return string("Warning: student ") + peopleMgr.text(peopleMgr.getStudentConst(s)->nameRef) + " enrolled in "
+            + to_string(peopleMgr.coursesOf(s).size()) + " courses (possible overload).";
+    }
+
+    string conflictText(long long key) const {
+        int f = static_cast<int>(key >> 32);
+        int r = static_cast<int>(key & 0xffffffffLL);
+        const PeopleManager::Faculty* fa = peopleMgr.getFaculty(f);
+        const PeopleManager::Room* ro = peopleMgr.getRoom(r);
+        return string("Conflict: Faculty ") + (fa ? string(peopleMgr.text(fa->nameRef)) : ("F#" + to_string(f)))
+            + " assigned to multiple courses in room " + (ro ? string(peopleMgr.text(ro->nameRef)) : ("R#" + to_string(r))) + ".";
+    }
+};
+
 // --------------------------- Recommender ---------------------------
 class Recommender {
 public:
     Recommender(const Relations& r, const CourseManager& cm) : relations(r), courseMgr(cm) {}
 
-    // suggest courses whose all indirect prereqs are completed
+    // suggest courses whose all indirect prereqs are completed; past the fixed
+    // engine the closure is built once per Recommender, so reuse one object
+    // across a batch of students
     vector<int> suggest(const vector<bool>& completed, int maxSuggest = 10) const {
+        UNIDISC_TIME(OpRecommend);
         vector<int> out;
         int n = relations.size();
-        vector<vector<bool>> cl = relations.closurePrereq();
+        bool fast = relations.withFixed([&](const auto& fr) {
+            auto done = fr.toBits(completed);
+            for (int c = 0; c < n && static_cast<int>(out.size()) < maxSuggest; ++c) {
+                if (!done.test(c) && fr.eligible(c, done)) out.push_back(c);
+            }
+        });
+        if (fast) return out;
+        if (static_cast<int>(needs.size()) != n) {
+            vector<vector<bool>> cl = relations.closurePrereq();
+            needs.assign(n, vector<int>());
+            for (int p = 0; p < n; ++p)
+                for (int c = 0; c < n; ++c) if (cl[p][c]) needs[c].push_back(p);
+        }
         for (int c = 0; c < n; ++c) {
             if (c < static_cast<int>(completed.size()) && completed[c]) continue;
             bool ok = true;
-            for (int p = 0; p < n; ++p) if (cl[p][c]) {
+            for (int p : needs[c]) {
                 if (!(p < static_cast<int>(completed.size()) && completed[p])) { ok = false; break; }
             }
             if (ok) out.push_back(c);
@@ -518,6 +1562,7 @@ public:
 private:
     const Relations& relations;
     const CourseManager& courseMgr;
+    mutable vector<vector<int>> needs; // needs[c]: every indirect prereq of c, from the closure
 };
 
 // --------------------------- Proof Exporter ---------------------------
@@ -527,9 +1572,10 @@ public:
 
     // generate textual proof for prerequisites of course c given completed vector
     string generateProof(int c, const vector<bool>& completed) const {
+        UNIDISC_TIME(OpProofGenerate);
         string proof;
         const CourseManager::Course* course = courseMgr.getCourse(c);
-        string cname = course ? course->code : ("C#" + to_string(c));
+        string cname = course ? courseMgr.text(course->codeRef) : ("C#" + to_string(c));
         proof += "Proof for prerequisites of ";
         proof += cname;
         proof += ".";
@@ -545,7 +1591,7 @@ public:
         for (int i = 0; i < n; ++i) if (cl[i][c]) {
             any = true;
             const CourseManager::Course* pc = courseMgr.getCourse(i);
-            string pname = pc ? pc->code : ("C#" + to_string(i));
+            string pname = pc ? courseMgr.text(pc->codeRef) : ("C#" + to_string(i));
             proof += "- Indirect prerequisite: ";
             proof += pname;
             proof += " : ";
@@ -577,6 +1623,7 @@ public:
     }
 
     bool saveToFile(const string& filename, const string& content) const {
+        UNIDISC_TIME(OpProofSave);
         ofstream ofs(filename.c_str());
         if (!ofs.is_open()) return false;
         ofs << content;
@@ -589,14 +1636,677 @@ private:
     const CourseManager& courseMgr;
 };
 
+// --------------------------- Query Service ---------------------------
+// Read-mostly concurrency: readers never touch live state. Each published
+// version is an immutable EngineSnapshot whose parts are reference-counted and
+// shared with the previous version unless a writer changed them (copy-on-write
+// per part). Copying a changed part is cheap too: PeopleManager shares its
+// directory and CsrRows blocks and Relations its matrix rows (CopyOnWrite), so
+// a publish after an enrollment or a prerequisite costs pointer copies plus
+// the one block or row that changed. Writers swap the current version with atomic_store and readers pick
+// it up with atomic_load, so the read path takes no engine locks; the only mutex
+// guards the worker pool's task queue.
+
+// const view over one consistent engine state (live or snapshot)
+struct EngineView {
+    const CourseManager& cm;
+    const PeopleManager& pm;
+    const Relations& rel;
+    const vector<int>& cToF;
+    const vector<int>& cToR;
+};
+
+struct EngineSnapshot {
+    shared_ptr<const CourseManager> cm;
+    shared_ptr<const PeopleManager> pm;
+    shared_ptr<const Relations> rel;
+    shared_ptr<const vector<int>> cToF;
+    shared_ptr<const vector<int>> cToR;
+    long long version;
+
+    EngineView view() const { return EngineView{ *cm, *pm, *rel, *cToF, *cToR }; }
+};
+
+class QueryService {
+public:
+    explicit QueryService(int workers) : stopping(false) {
+        if (workers < 1) workers = 1;
+        for (int i = 0; i < workers; ++i) pool.push_back(thread([this] { workerLoop(); }));
+    }
+
+    ~QueryService() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (thread& t : pool) t.join();
+    }
+
+    QueryService(const QueryService&) = delete;
+    QueryService& operator=(const QueryService&) = delete;
+
+    // writer side: make snap the version seen by every later snapshot() call
+    void publish(shared_ptr<const EngineSnapshot> snap) { atomic_store(&current, snap); }
+
+    // reader side: the latest published version (null before the first publish)
+    shared_ptr<const EngineSnapshot> snapshot() const { return atomic_load(&current); }
+
+    // run query on a worker against the version current at submit time; the
+    // snapshot is released as soon as the query returns, not when the future
+    // is read (a packaged_task would keep it alive in the shared state)
+    future<string> submit(function<string(const EngineSnapshot&)> query) {
+        shared_ptr<const EngineSnapshot> snap = snapshot();
+        auto done = make_shared<promise<string>>();
+        future<string> result = done->get_future();
+        {
+            lock_guard<mutex> lock(queueMutex);
+            tasks.push_back([snap, query, done] {
+                try { done->set_value(query(*snap)); }
+                catch (...) { done->set_exception(current_exception()); }
+            });
+        }
+        queueReady.notify_one();
+        return result;
+    }
+
+    int workers() const { return static_cast<int>(pool.size()); }
+
+private:
+    shared_ptr<const EngineSnapshot> current;
+    vector<thread> pool;
+    deque<function<void()>> tasks;
+    mutex queueMutex;
+    condition_variable queueReady;
+    bool stopping;
+
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+            task = nullptr; // drop the captured snapshot before waiting again
+        }
+    }
+};
+
+// --------------------------- Batch / Script Mode ---------------------------
+// Non-interactive driver: one command per line, no menus or prompts, and all
+// output goes through a single buffered stream (no per-line flush).
+//
+//   course CODE NAME CREDITS       student NAME      faculty NAME      room NAME
+//   prereq A B                     implies A B       assignf C F       assignr C R
+//   enroll S C [C ...]             list courses|students|faculty|rooms
+//   orders [LIMIT]                 induction C [DONE ...]    infer [ID ...]
+//   sets S1 S2                     functions         report
+//   recommend S [S ...] | all      proof C FILE|- [DONE ...]  exit
+//   find course|student|faculty|room KEY                     roster C
+//   eligible S C                   wait              violations
+//   reduce [apply | export FILE]     stats [reset]
+//
+// Mutations print "Violation: ..." for every consistency violation they raise;
+// 'violations' lists the live set kept by ConsistencyMonitor.
+// Course, student, faculty and room arguments take a code/name or an id.
+// "#N" always means id N; a bare token is looked up as an exact code/name
+// first and only read as an id when nothing matches, so all-digit codes and
+// names stay reachable.
+// Blank lines and lines starting with '#' are ignored.
+//
+// With a QueryService, read-only commands run on its workers against the
+// snapshot current when the line was read. Their output is held back and
+// printed at 'wait', at the end of the script, or when too many results are
+// outstanding; output of later lines (writes, violations, errors) queues
+// behind them, so the transcript matches a run without workers. Outstanding
+// queries pin at most workers + 1 versions: publishing another first prints
+// the queries of the oldest one.
+
+// read-only commands; everything here goes through an EngineView
+class BatchQueries {
+public:
+    static bool isQuery(const string& cmd) {
+        static const char* const names[] = { "list", "orders", "induction", "infer", "sets", "functions",
+            "find", "roster", "report", "recommend", "eligible", "proof" };
+        for (const char* n : names) if (cmd == n) return true;
+        return false;
+    }
+
+    static void split(const string& line, vector<string>& args) {
+        args.clear();
+        size_t i = 0;
+        while (i < line.size()) {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+            size_t j = i;
+            while (j < line.size() && line[j] != ' ' && line[j] != '\t' && line[j] != '\r') ++j;
+            if (j > i) args.push_back(line.substr(i, j - i));
+            i = j;
+        }
+    }
+
+    static bool toInt(const string& s, int& v) {
+        if (s.empty()) return false;
+        size_t i = (s[0] == '-' || s[0] == '+') ? 1 : 0;
+        if (i == s.size()) return false;
+        long long acc = 0;
+        for (; i < s.size(); ++i) {
+            if (s[i] < '0' || s[i] > '9') return false;
+            acc = acc * 10 + (s[i] - '0');
+            if (acc > 2147483647LL) return false;
+        }
+        v = static_cast<int>(s[0] == '-' ? -acc : acc);
+        return true;
+    }
+
+    // entity argument given byKey, the exact code/name match for tok (or -1):
+    // "#N" is id N, then the match wins, then a bare number is read as an id
+    static bool entityArg(const string& tok, int byKey, int& id) {
+        if (tok.size() > 1 && tok[0] == '#') return toInt(tok.substr(1), id);
+        if (byKey != -1) { id = byKey; return true; }
+        return toInt(tok, id);
+    }
+    static bool courseArg(const EngineView& v, const string& tok, int& id) {
+        return entityArg(tok, v.cm.findByCode(tok), id);
+    }
+    static bool studentArg(const EngineView& v, const string& tok, int& id) {
+        return entityArg(tok, v.pm.findStudent(tok), id);
+    }
+    static bool courseArgs(const EngineView& v, const vector<string>& args, size_t from, vector<int>& ids) {
+        ids.clear();
+        for (size_t i = from; i < args.size(); ++i) {
+            int id;
+            if (!courseArg(v, args[i], id)) return false;
+            ids.push_back(id);
+        }
+        return true;
+    }
+
+    // run one read-only command; returns an error message or "" on success
+    static string run(const EngineView& v, const vector<string>& args, ostream& out) {
+        const string& cmd = args[0];
+        size_t argc = args.size() - 1;
+        int a = 0, b = 0;
+        vector<int> ids;
+
+        if (cmd == "list") {
+            string what = argc == 1 ? args[1] : "";
+            if (what == "courses") v.cm.listAll(out);
+            else if (what == "students") v.pm.listAllStudents(out);
+            else if (what == "faculty") v.pm.listAllFaculties(out);
+            else if (what == "rooms") v.pm.listAllRooms(out);
+            else return "usage: list courses|students|faculty|rooms";
+        }
+        else if (cmd == "orders") {
+            int limit = 200;
+            if (argc > 1 || (argc == 1 && !toInt(args[1], limit))) return "usage: orders [LIMIT]";
+            int n = v.cm.count();
+            if (n == 0) return "No courses available.";
+            if (v.rel.hasPrereqCycle()) return "Prereq cycle exists; cannot list orders.";
+            Scheduling sched(v.rel);
+            vector<vector<int>> orders = sched.listOrders(n, limit);
+            for (const auto& order : orders) {
+                for (size_t j = 0; j < order.size(); ++j) {
+                    out << courseLabel(v, order[j]);
+                    if (j + 1 < order.size()) out << " -> ";
+                }
+                out << "\n";
+            }
+            out << "Total shown: " << orders.size() << "\n";
+        }
+        else if (cmd == "induction") {
+            if (argc < 1 || !courseArg(v, args[1], a) || !courseArgs(v, args, 2, ids)) return "usage: induction C [DONE ...]";
+            vector<bool> completed = markCompleted(ids, v.rel.size());
+            Induction ind(v.rel);
+            out << "Recursive check: " << (ind.checkRecursive(a, completed) ? "SATISFIED" : "NOT SATISFIED") << "\n";
+            out << "Strong induction check: " << (ind.checkStrong(a, completed) ? "SATISFIED" : "NOT SATISFIED") << "\n";
+            out << "Indirect prerequisites: ";
+            for (int id : ind.listIndirect(a)) out << id << " ";
+            out << "\n";
+        }
+        else if (cmd == "infer") {
+            if (!courseArgs(v, args, 1, ids)) return "usage: infer [ID ...]";
+            Logic logic(v.rel);
+            vector<bool> after = logic.applyImplications(markCompleted(ids, v.rel.size()));
+            out << "Facts after applying implications: ";
+            for (int i = 0; i < static_cast<int>(after.size()); ++i) if (after[i]) out << courseLabel(v, i) << " ";
+            out << "\n";
+        }
+        else if (cmd == "sets") {
+            if (argc != 2 || !studentArg(v, args[1], a) || !studentArg(v, args[2], b)) return "usage: sets S1 S2";
+            if (!v.pm.getStudentConst(a) || !v.pm.getStudentConst(b)) return "Invalid student ids.";
+            vector<int> e1 = v.pm.coursesOf(a).toVector();
+            vector<int> e2 = v.pm.coursesOf(b).toVector();
+            printSet(v, out, "Union", SetOps::unionSet(e1, e2));
+            printSet(v, out, "Intersection", SetOps::intersection(e1, e2));
+            printSet(v, out, "Difference (s1 - s2)", SetOps::difference(e1, e2));
+        }
+        else if (cmd == "functions") {
+            int n = v.cm.count();
+            int facCount = static_cast<int>(v.pm.listFaculties().size());
+            vector<int> domain, codomain;
+            for (int i = 0; i < n; ++i) {
+                domain.push_back(i);
+                codomain.push_back(i < static_cast<int>(v.cToF.size()) ? v.cToF[i] : -1);
+            }
+            out << "Function? " << (Functions::isFunction(domain, codomain) ? "Yes" : "No") << "\n";
+            out << "Injective? " << (Functions::isInjective(domain, codomain) ? "Yes" : "No") << "\n";
+            out << "Surjective? " << (Functions::isSurjective(domain, codomain, facCount) ? "Yes" : "No") << "\n";
+            out << "Bijective? " << (Functions::isBijective(domain, codomain, facCount) ? "Yes" : "No") << "\n";
+        }
+        else if (cmd == "find") {
+            if (argc != 2) return "usage: find course|student|faculty|room KEY";
+            const string& kind = args[1];
+            if (kind == "course") a = v.cm.findByCode(args[2]);
+            else if (kind == "student") a = v.pm.findStudent(args[2]);
+            else if (kind == "faculty") a = v.pm.findFaculty(args[2]);
+            else if (kind == "room") a = v.pm.findRoom(args[2]);
+            else return "usage: find course|student|faculty|room KEY";
+            if (a == -1) return "No " + kind + " named " + args[2] + ".";
+            out << kind << " " << args[2] << " id=" << a << "\n";
+        }
+        else if (cmd == "roster") {
+            if (argc != 1 || !courseArg(v, args[1], a)) return "usage: roster C";
+            if (a < 0 || a >= v.cm.count()) return "Invalid course id.";
+            out << "Roster of " << courseLabel(v, a) << ": ";
+            vector<int> roster = v.pm.rosterOf(a).toVector(); // enrollment order; list by id
+            sort(roster.begin(), roster.end());
+            for (int sid : roster) out << v.pm.text(v.pm.getStudentConst(sid)->nameRef) << " ";
+            out << "\n";
+        }
+        else if (cmd == "report") {
+            Consistency cons(v.rel, v.cm, v.pm, v.cToF, v.cToR);
+            cons.runAllChecks(out);
+        }
+        else if (cmd == "recommend") {
+            if (argc == 1 && args[1] == "all") {
+                for (const auto& s : v.pm.listStudents()) ids.push_back(s.id);
+            }
+            else {
+                if (argc < 1) return "usage: recommend S [S ...] | all";
+                ids.assign(argc, -1);
+                for (size_t i = 0; i < argc; ++i) if (!studentArg(v, args[i + 1], ids[i])) return "Unknown student " + args[i + 1] + ".";
+            }
+            Recommender rec(v.rel, v.cm);
+            int n = v.rel.size();
+            for (int sid : ids) {
+                if (!v.pm.getStudentConst(sid)) return "Invalid student id " + to_string(sid) + ".";
+                vector<bool> completed = markCompleted(v.pm.coursesOf(sid).toVector(), n);
+                out << "Recommended for " << sid << ": ";
+                for (int c : rec.suggest(completed, 10)) out << courseLabel(v, c) << " ";
+                out << "\n";
+            }
+        }
+        else if (cmd == "eligible") {
+            if (argc != 2 || !studentArg(v, args[1], a) || !courseArg(v, args[2], b)) return "usage: eligible S C";
+            if (!v.pm.getStudentConst(a)) return "Invalid student id.";
+            Induction ind(v.rel);
+            bool ok = ind.checkStrong(b, markCompleted(v.pm.coursesOf(a).toVector(), v.rel.size()));
+            out << "Student " << a << (ok ? " is" : " is NOT") << " eligible for " << courseLabel(v, b) << "\n";
+        }
+        else if (cmd == "proof") {
+            if (argc < 2 || !courseArg(v, args[1], a) || !courseArgs(v, args, 3, ids)) return "usage: proof C FILE|- [DONE ...]";
+            ProofExporter pe(v.rel, v.cm);
+            string proof = pe.generateProof(a, markCompleted(ids, v.rel.size()));
+            if (args[2] == "-") out << proof;
+            else out << (pe.saveToFile(args[2], proof) ? "Saved " : "Failed to save ") << args[2] << "\n";
+        }
+        else {
+            return "unknown command '" + cmd + "'";
+        }
+        return "";
+    }
+
+private:
+    static string courseLabel(const EngineView& v, int c) {
+        const CourseManager::Course* cp = v.cm.getCourse(c);
+        return cp ? v.cm.text(cp->codeRef) : to_string(c);
+    }
+
+    static vector<bool> markCompleted(const vector<int>& ids, int n) {
+        vector<bool> completed(n, false);
+        for (int x : ids) if (x >= 0 && x < n) completed[x] = true;
+        return completed;
+    }
+
+    static void printSet(const EngineView& v, ostream& out, const char* label, const vector<int>& ids) {
+        out << label << ": ";
+        for (int x : ids) out << courseLabel(v, x) << " ";
+        out << "\n";
+    }
+};
+
+class BatchRunner {
+public:
+    BatchRunner(CourseManager& cmRef, PeopleManager& pmRef, Relations& relRef,
+        vector<int>& courseToFaculty, vector<int>& courseToRoom, ostream& o, QueryService* svc = nullptr)
+        : cm(cmRef), pm(pmRef), rel(relRef), cToF(courseToFaculty), cToR(courseToRoom), out(o),
+        service(svc), monitor(relRef, cmRef, pmRef, courseToFaculty, courseToRoom),
+        dirty(AllParts), errors(0), version(0) {
+    }
+
+    // execute every command in the stream; returns the number of failed lines
+    int run(istream& in) {
+        errors = 0;
+        int lineNo = 0;
+        string line;
+        vector<string> args;
+        while (getline(in, line)) {
+            ++lineNo;
+            BatchQueries::split(line, args);
+            if (args.empty() || args[0][0] == '#') continue;
+            if (args[0] == "exit" || args[0] == "quit") break;
+            if (args[0] == "wait") { drain(0); continue; }
+            if (service && BatchQueries::isQuery(args[0])) {
+                submit(lineNo, args);
+                continue;
+            }
+            // behind outstanding queries, keep script order by queueing the output too
+            ostringstream held;
+            ostream& os = pending.empty() ? out : held;
+            EngineView live{ cm, pm, rel, cToF, cToR };
+            vector<string> raised;
+            string err = BatchQueries::isQuery(args[0]) ? BatchQueries::run(live, args, os) : execute(args, os, raised);
+            for (const string& v : raised) os << "Violation: " << v << "\n";
+            if (&os == &out) { report(lineNo, err); continue; }
+            Pending p;
+            p.lineNo = lineNo;
+            p.version = 0;
+            p.text = err + "\n" + held.str();
+            pending.push_back(move(p));
+        }
+        drain(0);
+        out.flush();
+        return errors;
+    }
+
+private:
+    enum Part { Courses = 1, People = 2, Rels = 4, Assignments = 8, AllParts = 15 };
+
+    // one line's output in script order: a query still running on a worker
+    // (result valid, pinning snapshot version) or text already produced
+    struct Pending {
+        int lineNo;
+        long long version;
+        future<string> result; // "err\n" + output
+        string text;           // same format, when result is not valid
+    };
+
+    CourseManager& cm;
+    PeopleManager& pm;
+    Relations& rel;
+    vector<int>& cToF;
+    vector<int>& cToR;
+    ostream& out;
+    QueryService* service;
+    ConsistencyMonitor monitor; // live violations, updated by every mutation below
+    int dirty;          // parts changed since the last published snapshot
+    int errors;
+    long long version;
+    deque<Pending> pending;
+
+    static const size_t MaxPending = 4096;
+
+    void report(int lineNo, const string& err) {
+        if (err.empty()) return;
+        out << "line " << lineNo << ": " << err << "\n";
+        ++errors;
+    }
+
+    // copy only the parts that changed; unchanged parts stay shared with the
+    // previous version
+    void publishIfDirty() {
+        if (!dirty) return;
+        limitVersions();
+        shared_ptr<const EngineSnapshot> prev = service->snapshot();
+        auto next = make_shared<EngineSnapshot>();
+        next->cm = (dirty & Courses) || !prev ? make_shared<const CourseManager>(cm) : prev->cm;
+        next->pm = (dirty & People) || !prev ? make_shared<const PeopleManager>(pm) : prev->pm;
+        next->rel = (dirty & Rels) || !prev ? make_shared<const Relations>(rel) : prev->rel;
+        bool assign = (dirty & Assignments) || !prev;
+        next->cToF = assign ? make_shared<const vector<int>>(cToF) : prev->cToF;
+        next->cToR = assign ? make_shared<const vector<int>>(cToR) : prev->cToR;
+        next->version = ++version;
+        service->publish(next);
+        dirty = 0;
+    }
+
+    void submit(int lineNo, const vector<string>& args) {
+        publishIfDirty();
+        Pending p;
+        p.lineNo = lineNo;
+        p.version = version;
+        p.result = service->submit([args](const EngineSnapshot& snap) {
+            ostringstream buf;
+            string err = BatchQueries::run(snap.view(), args, buf);
+            return err + "\n" + buf.str();
+        });
+        pending.push_back(move(p));
+        if (pending.size() > MaxPending) drain(MaxPending / 2);
+    }
+
+    // print queued output in script order until at most keep entries remain
+    void drain(size_t keep) {
+        while (pending.size() > keep) {
+            Pending& p = pending.front();
+            string r = p.result.valid() ? p.result.get() : p.text;
+            size_t nl = r.find('\n');
+            out << r.substr(nl + 1);
+            report(p.lineNo, r.substr(0, nl));
+            pending.pop_front();
+        }
+    }
+
+    // before publishing a new version, print the oldest pinned version's
+    // queries until fewer than workers + 1 versions are pinned
+    void limitVersions() {
+        size_t limit = static_cast<size_t>(service->workers()) + 1;
+        while (true) {
+            size_t pinned = 0, oldestEnd = 0;
+            long long last = -1;
+            for (size_t i = 0; i < pending.size(); ++i) {
+                Pending& p = pending[i];
+                if (!p.result.valid() || p.version == last) continue;
+                if (p.result.wait_for(chrono::seconds(0)) == future_status::ready) continue; // already released
+                last = p.version;
+                if (++pinned == 2) oldestEnd = i;
+            }
+            if (pinned < limit) return;
+            drain(pending.size() - oldestEnd);
+        }
+    }
+
+    string courseLabel(int c) const {
+        const CourseManager::Course* cp = cm.getCourse(c);
+        return cp ? cm.text(cp->codeRef) : to_string(c);
+    }
+
+    // argument form that resolves back to c: its code when that is the
+    // first course with it and cannot be read as "#N", else "#id"
+    string courseToken(int c) const {
+        const CourseManager::Course* cp = cm.getCourse(c);
+        string code = cp ? cm.text(cp->codeRef) : "";
+        if (code.empty() || code[0] == '#' || cm.findByCode(code) != c) return "#" + to_string(c);
+        return code;
+    }
+
+    void syncCourseTables() {
+        rel.ensureSize(cm.count());
+        if (static_cast<int>(cToF.size()) < cm.count()) cToF.resize(cm.count(), -1);
+        if (static_cast<int>(cToR.size()) < cm.count()) cToR.resize(cm.count(), -1);
+    }
+
+    // run one mutating command, printing to os; returns an error message or ""
+    // on success and appends any violation the change raised to raised
+    string execute(const vector<string>& args, ostream& os, vector<string>& raised) {
+        const string& cmd = args[0];
+        size_t argc = args.size() - 1;
+        int a = 0, b = 0;
+        vector<int> ids;
+        EngineView live{ cm, pm, rel, cToF, cToR };
+
+        if (cmd == "course") {
+            if (argc != 3 || !BatchQueries::toInt(args[3], a)) return "usage: course CODE NAME CREDITS";
+            int id = cm.addCourse(args[1], args[2], a);
+            syncCourseTables();
+            dirty |= Courses | Rels | Assignments;
+            os << "Added course id=" << id << "\n";
+        }
+        else if (cmd == "student" || cmd == "faculty" || cmd == "room") {
+            if (argc != 1) return "usage: " + cmd + " NAME";
+            int id = cmd == "student" ? pm.addStudent(args[1])
+                : cmd == "faculty" ? pm.addFaculty(args[1]) : pm.addRoom(args[1]);
+            dirty |= People;
+            os << "Added " << cmd << " id=" << id << "\n";
+        }
+        else if (cmd == "prereq" || cmd == "implies") {
+            if (argc != 2 || !BatchQueries::courseArg(live, args[1], a) || !BatchQueries::courseArg(live, args[2], b))
+                return "usage: " + cmd + " A B";
+            if (a < 0 || a >= cm.count() || b < 0 || b >= cm.count()) return "Invalid course id.";
+            rel.ensureSize(cm.count());
+            if (cmd == "prereq") {
+                rel.addPrereq(a, b);
+                monitor.onPrereq(a, b, &raised);
+            }
+            else rel.addImplication(a, b);
+            dirty |= Rels;
+            os << (cmd == "prereq" ? "Prerequisite" : "Implication") << " added: " << a << " -> " << b << "\n";
+        }
+        else if (cmd == "assignf" || cmd == "assignr") {
+            bool fac = cmd == "assignf";
+            if (argc != 2 || !BatchQueries::courseArg(live, args[1], a)) return "usage: " + cmd + " COURSE ID";
+            if (!BatchQueries::entityArg(args[2], fac ? pm.findFaculty(args[2]) : pm.findRoom(args[2]), b)) b = -1;
+            if (a < 0 || a >= cm.count()) return "Invalid course id.";
+            int limit = static_cast<int>(fac ? pm.listFaculties().size() : pm.listRooms().size());
+            if (b < 0 || b >= limit) return fac ? "Invalid faculty id." : "Invalid room id.";
+            syncCourseTables();
+            (fac ? cToF : cToR)[a] = b;
+            monitor.onAssign(a, &raised);
+            dirty |= Assignments;
+            os << "Assigned " << (fac ? "faculty " : "room ") << b << " to course " << a << "\n";
+        }
+        else if (cmd == "enroll") {
+            if (argc < 2 || !BatchQueries::studentArg(live, args[1], a) || !BatchQueries::courseArgs(live, args, 2, ids))
+                return "usage: enroll S C [C ...]";
+            if (!pm.getStudentConst(a)) return "Invalid student id.";
+            // all or nothing: reject the line before enrolling any course
+            for (int c : ids) if (c < 0 || c >= cm.count()) return "Invalid course id " + to_string(c) + ".";
+            for (int c : ids) {
+                if (pm.enroll(a, c)) monitor.onEnroll(a, c, &raised);
+                dirty |= People;
+                os << "Enrolled student " << a << " in course " << c << "\n";
+            }
+        }
+        else if (cmd == "violations") {
+            monitor.print(os);
+        }
+        else if (cmd == "stats") {
+            if (argc > 1 || (argc == 1 && args[1] != "reset")) return "usage: stats [reset]";
+            drain(0); // count queries still running on workers
+#if UNIDISC_STATS
+            if (argc == 1) Stats::reset();
+            else Stats::print(os);
+#else
+            os << "Instrumentation disabled in this build (compile with UNIDISC_STATS=1)." << "\n";
+#endif
+        }
+        else if (cmd == "reduce") {
+            string mode = argc >= 1 ? args[1] : "";
+            if (argc > 2 || (argc >= 1 && mode != "apply" && mode != "export") || (mode == "export") != (argc == 2))
+                return "usage: reduce [apply | export FILE]";
+            vector<pair<int, int>> minimal, redundant;
+            if (!rel.reducePrereq(minimal, redundant)) return "Prereq cycle exists; no unique reduction.";
+            os << "Redundant prerequisites (" << redundant.size() << "): ";
+            for (const auto& e : redundant) os << courseLabel(e.first) << "->" << courseLabel(e.second) << " ";
+            os << "\n" << "Minimal prerequisite edges: " << minimal.size() << "\n";
+            if (mode == "apply") {
+                for (const auto& e : redundant) rel.removePrereq(e.first, e.second);
+                if (!redundant.empty()) dirty |= Rels;
+                os << "Removed " << redundant.size() << " redundant edges." << "\n";
+            }
+            else if (mode == "export") {
+                UNIDISC_TIME(OpReduceExport);
+                ofstream ofs(args[2].c_str());
+                if (!ofs.is_open()) return "Failed to save " + args[2];
+                for (const auto& e : minimal) ofs << "prereq " << courseToken(e.first) << " " << courseToken(e.second) << "\n";
+                os << "Saved " << args[2] << "\n";
+            }
+        }
+        else {
+            return "unknown command '" + cmd + "'";
+        }
+        return "";
+    }
+};
+
 // --------------------------- Interactive CLI ---------------------------
-int main() {
+// bench/bench_engine.cpp includes this file with UNIDISC_NO_MAIN defined
+#ifndef UNIDISC_NO_MAIN
+int main(int argc, char* argv[]) {
     CourseManager cm;
     PeopleManager pm;
     Relations rel;
     vector<int> courseToFaculty; // index by course id
     vector<int> courseToRoom;    // index by course id
 
+    // UNIDISC [--batch [script] [--workers N]] [--stats-dump FILE [--stats-interval SEC]]
+    // batch mode reads stdin when no script is given, so commands can be piped in
+    bool batch = false, haveWorkers = false, haveInterval = false;
+    string scriptName, statsDump, argError;
+    int workers = 0, statsInterval = 60;
+    for (int i = 1; i < argc && argError.empty(); ++i) {
+        string arg = argv[i];
+        bool takesValue = arg == "--workers" || arg == "--stats-dump" || arg == "--stats-interval";
+        if (takesValue && i + 1 >= argc) argError = "missing value for " + arg;
+        else if (arg == "--batch") batch = true;
+        else if (arg == "--workers") {
+            haveWorkers = true;
+            if (!BatchQueries::toInt(argv[++i], workers) || workers < 0) argError = "--workers needs a count >= 0";
+        }
+        else if (arg == "--stats-dump") statsDump = argv[++i];
+        else if (arg == "--stats-interval") {
+            haveInterval = true;
+            if (!BatchQueries::toInt(argv[++i], statsInterval) || statsInterval <= 0) argError = "--stats-interval needs seconds > 0";
+        }
+        else if (arg.size() > 1 && arg[0] == '-') argError = "unknown option " + arg;
+        else if (!scriptName.empty()) argError = "more than one script given";
+        else scriptName = arg;
+    }
+    if (argError.empty() && !batch && !scriptName.empty()) argError = "a script needs --batch";
+    if (argError.empty() && !batch && haveWorkers) argError = "--workers needs --batch";
+    if (argError.empty() && statsDump.empty() && haveInterval) argError = "--stats-interval needs --stats-dump";
+    if (!argError.empty()) {
+        cerr << argError << "\n"
+            << "usage: UNIDISC [--batch [script] [--workers N]] [--stats-dump FILE [--stats-interval SEC]]" << endl;
+        return 2;
+    }
+#if UNIDISC_STATS
+    if (!statsDump.empty()) Stats::configureDump(statsDump, statsInterval);
+    struct FinalDump { ~FinalDump() { Stats::stopDump(); Stats::dump(); } } finalDump;
+#else
+    if (!statsDump.empty()) cerr << "Instrumentation disabled in this build; --stats-dump ignored." << endl;
+#endif
+
+    if (batch) {
+        ios::sync_with_stdio(false);
+        cin.tie(nullptr);
+        unique_ptr<QueryService> service;
+        if (workers > 0) service.reset(new QueryService(workers));
+        BatchRunner runner(cm, pm, rel, courseToFaculty, courseToRoom, cout, service.get());
+        if (!scriptName.empty()) {
+            ifstream script(scriptName.c_str());
+            if (!script.is_open()) { cerr << "Cannot open script " << scriptName << endl; return 2; }
+            return runner.run(script) == 0 ? 0 : 1;
+        }
+        return runner.run(cin) == 0 ? 0 : 1;
+    }
+
+    ConsistencyMonitor monitor(rel, cm, pm, courseToFaculty, courseToRoom);
+    vector<string> raised; // violations raised by the last mutation
+
     cout << "Welcome to UNIDISC ENGINE " << endl;
 
     while (true) {
@@ -620,9 +2330,13 @@ int main() {
         cout << "16 Consistency report" << endl;
         cout << "17 Smart recommendations for a student" << endl;
         cout << "18 Generate & save proof for a course" << endl;
+        cout << "19 Outstanding violations (live)" << endl;
+        cout << "20 Transitive reduction of prerequisites" << endl;
+        cout << "21 Instrumentation stats" << endl;
         cout << "0 Exit" << endl;
         cout << "Enter choice: ";
         int choice; cin >> choice;
+        raised.clear();
 
         if (choice == 0) {
             cout << "Exiting. Goodbye." << endl;
@@ -662,6 +2376,7 @@ int main() {
             cout << "Enter dependent course id B (dependent): "; cin >> b;
             rel.ensureSize(cm.count());
             rel.addPrereq(a, b);
+            monitor.onPrereq(a, b, &raised);
             cout << "Prerequisite added: " << a << " -> " << b << endl;
         }
         else if (choice == 6) {
@@ -677,6 +2392,7 @@ int main() {
             if (f < 0 || f >= static_cast<int>(pm.listFaculties().size())) { cout << "Invalid faculty id." << endl; continue; }
             if (static_cast<int>(courseToFaculty.size()) < cm.count()) courseToFaculty.resize(cm.count(), -1);
             courseToFaculty[c] = f;
+            monitor.onAssign(c, &raised);
             cout << "Assigned faculty " << f << " to course " << c << endl;
         }
         else if (choice == 8) {
@@ -685,6 +2401,7 @@ int main() {
             if (r < 0 || r >= static_cast<int>(pm.listRooms().size())) { cout << "Invalid room id." << endl; continue; }
             if (static_cast<int>(courseToRoom.size()) < cm.count()) courseToRoom.resize(cm.count(), -1);
             courseToRoom[c] = r;
+            monitor.onAssign(c, &raised);
             cout << "Assigned room " << r << " to course " << c << endl;
         }
         else if (choice == 9) {
@@ -692,9 +2409,7 @@ int main() {
             PeopleManager::Student* st = pm.getStudent(s);
             if (!st) { cout << "Invalid student id." << endl; continue; }
             if (c < 0 || c >= cm.count()) { cout << "Invalid course id." << endl; continue; }
-            bool already = false;
-            for (int x : st->enrolled) if (x == c) already = true;
-            if (!already) st->enrolled.push_back(c);
+            if (pm.enroll(s, c)) monitor.onEnroll(s, c, &raised);
             cout << "Enrolled student " << s << " in course " << c << endl;
         }
         else if (choice == 10) {
@@ -720,7 +2435,7 @@ int main() {
             for (size_t i = 0; i < orders.size(); ++i) {
                 for (size_t j = 0; j < orders[i].size(); ++j) {
                     const CourseManager::Course* cptr = cm.getCourse(orders[i][j]);
-                    if (cptr) cout << cptr->code;
+                    if (cptr) cout << cm.text(cptr->codeRef);
                     else cout << orders[i][j];
                     if (j + 1 < orders[i].size()) cout << " -> ";
                 }
@@ -758,7 +2473,7 @@ int main() {
             cout << "Facts after applying implications:" << endl;
             for (int i = 0; i < static_cast<int>(after.size()); ++i) if (after[i]) {
                 const CourseManager::Course* cptr = cm.getCourse(i);
-                cout << (cptr ? cptr->code : to_string(i)) << " ";
+                cout << (cptr ? cm.text(cptr->codeRef) : to_string(i)) << " ";
             }
             cout << endl;
         }
@@ -768,19 +2483,21 @@ int main() {
             PeopleManager::Student* st1 = pm.getStudent(s1);
             PeopleManager::Student* st2 = pm.getStudent(s2);
             if (!st1 || !st2) { cout << "Invalid student ids." << endl; continue; }
-            vector<int> u = SetOps::unionSet(st1->enrolled, st2->enrolled);
-            vector<int> it = SetOps::intersection(st1->enrolled, st2->enrolled);
-            vector<int> di = SetOps::difference(st1->enrolled, st2->enrolled);
-            cout << "Union: "; for (int x : u) { const CourseManager::Course* cptr = cm.getCourse(x); cout << (cptr ? cptr->code : to_string(x)) << " "; } cout << endl;
-            cout << "Intersection: "; for (int x : it) { const CourseManager::Course* cptr = cm.getCourse(x); cout << (cptr ? cptr->code : to_string(x)) << " "; } cout << endl;
-            cout << "Difference (s1 - s2): "; for (int x : di) { const CourseManager::Course* cptr = cm.getCourse(x); cout << (cptr ? cptr->code : to_string(x)) << " "; } cout << endl;
+            vector<int> e1 = pm.coursesOf(s1).toVector();
+            vector<int> e2 = pm.coursesOf(s2).toVector();
+            vector<int> u = SetOps::unionSet(e1, e2);
+            vector<int> it = SetOps::intersection(e1, e2);
+            vector<int> di = SetOps::difference(e1, e2);
+            cout << "Union: "; for (int x : u) { const CourseManager::Course* cptr = cm.getCourse(x); cout << (cptr ? cm.text(cptr->codeRef) : to_string(x)) << " "; } cout << endl;
+            cout << "Intersection: "; for (int x : it) { const CourseManager::Course* cptr = cm.getCourse(x); cout << (cptr ? cm.text(cptr->codeRef) : to_string(x)) << " "; } cout << endl;
+            cout << "Difference (s1 - s2): "; for (int x : di) { const CourseManager::Course* cptr = cm.getCourse(x); cout << (cptr ? cm.text(cptr->codeRef) : to_string(x)) << " "; } cout << endl;
             cout << "Power set of student1 courses (limited):" << endl;
-            vector<vector<int>> ps = SetOps::powerSet(st1->enrolled);
+            vector<vector<int>> ps = SetOps::powerSet(e1);
             for (size_t i = 0; i < ps.size(); ++i) {
                 cout << "{";
                 for (size_t j = 0; j < ps[i].size(); ++j) {
                     const CourseManager::Course* cptr = cm.getCourse(ps[i][j]);
-                    cout << (cptr ? cptr->code : to_string(ps[i][j]));
+                    cout << (cptr ? cm.text(cptr->codeRef) : to_string(ps[i][j]));
                     if (j + 1 < ps[i].size()) cout << ",";
                 }
                 cout << "}" << endl;
@@ -814,13 +2531,13 @@ int main() {
             if (!st) { cout << "Invalid student id." << endl; continue; }
             int n = rel.size();
             vector<bool> completed(n, false);
-            for (int c : st->enrolled) if (c >= 0 && c < n) completed[c] = true;
+            for (int c : pm.coursesOf(sid)) if (c >= 0 && c < n) completed[c] = true;
             Recommender rec(rel, cm);
             vector<int> suggestions = rec.suggest(completed, 10);
             cout << "Recommended next courses:" << endl;
             for (int c : suggestions) {
                 const CourseManager::Course* cp = cm.getCourse(c);
-                cout << (cp ? cp->code : to_string(c)) << " ";
+                cout << (cp ? cm.text(cp->codeRef) : to_string(c)) << " ";
             }
             cout << endl;
         }
@@ -841,11 +2558,42 @@ int main() {
                 cout << (ok ? "Saved." : "Failed to save.") << endl;
             }
         }
+        else if (choice == 19) {
+            monitor.print(cout);
+        }
+        else if (choice == 20) {
+            vector<pair<int, int>> minimal, redundant;
+            if (!rel.reducePrereq(minimal, redundant)) { cout << "Prereq cycle exists; no unique reduction." << endl; continue; }
+            cout << "Redundant prerequisites (" << redundant.size() << "):" << endl;
+            for (const auto& e : redundant) {
+                const CourseManager::Course* pa = cm.getCourse(e.first);
+                const CourseManager::Course* pb = cm.getCourse(e.second);
+                cout << (pa ? cm.text(pa->codeRef) : to_string(e.first)) << " -> "
+                    << (pb ? cm.text(pb->codeRef) : to_string(e.second)) << endl;
+            }
+            cout << "Minimal prerequisite edges: " << minimal.size() << endl;
+            if (!redundant.empty()) {
+                cout << "Remove redundant edges? (y/n): "; string ans; cin >> ans;
+                if (ans == "y") {
+                    for (const auto& e : redundant) rel.removePrereq(e.first, e.second);
+                    cout << "Removed " << redundant.size() << " redundant edges." << endl;
+                }
+            }
+        }
+        else if (choice == 21) {
+#if UNIDISC_STATS
+            Stats::print(cout);
+#else
+            cout << "Instrumentation disabled in this build (compile with UNIDISC_STATS=1)." << endl;
+#endif
+        }
         else {
             cout << "Unknown choice." << endl;
         }
+        for (const string& v : raised) cout << "Violation: " << v << endl;
     }
 
     return 0;
 }
+#endif // UNIDISC_NO_MAIN
 //git 
\ No newline at end of file
@@ -0,0 +1,346 @@
+// File: bench_engine.cpp
+// Microbenchmarks for the UNIDISC engine's hot paths on synthetic catalogs.
+// Builds the engine from the single source file and writes one CSV row per
+// (operation, scale):
+//   op,courses,students,prereq_edges,enrollments,reps,mean_ns,min_ns,status
+//
+// Usage: unidisc_bench [--scales 100,1000,10000] [--density 3] [--layers 8]
+//                      [--students-per-course 2] [--per-student 5]
+//                      [--dist uniform|zipf] [--seed 1] [--min-ms 50]
+//                      [--max-reps 1000] [--max-cubic 2000] [--max-matrix 20000]
+//                      [--enroll-scales 250000,1000000,2000000] [--out results.csv]
+//
+// Real coverage limits with the defaults:
+//   - closure-based operations are O(n^3) on the dense matrix and run only up
+//     to --max-cubic (2000 courses); larger scales report them as "skipped";
+//   - Relations keeps n*n bits per relation (about 2.5 GB for two relations at
+//     100k courses), so only scales up to --max-matrix build the prerequisite
+//     graph; there the sparse "Relations::reducePrereq" row still runs;
+//   - above --max-matrix only the hash, CSR and set rows (findByCode,
+//     isEnrolled, coursesOf, SetOps) are measured, on a catalog without
+//     relations. Those are the only rows that reach e.g. --scales 100000.
+//
+// Up to 256 courses the closure rows measure the warm engine: the first call
+// builds the fixed-width closure and later reps reuse the cached copy. The
+// "Relations::withFixed(cold)" row drops the cache every rep (by toggling one
+// prerequisite edge) to time the rebuild itself.
+//
+// Each --enroll-scales entry E enrolls E random pairs into a fresh
+// PeopleManager (200 courses, E/5 students) and reports one
+// "PeopleManager::enroll" row whose mean_ns/min_ns are per enrollment. Every
+// insert touches a random student row, so once the enrollment blocks outgrow
+// the caches the per-enrollment cost climbs slowly with E (memory latency,
+// roughly 200-700 ns from 250k to 8M). Only growth proportional to E, i.e.
+// quadratic total time, indicates a regression.
+
+#define UNIDISC_NO_MAIN
+#include "../Hamna DS4.cpp"
+
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+
+// --------------------------- Options ---------------------------
+struct BenchOptions {
+    vector<int> scales{ 100, 1000, 10000 };
+    double density = 3.0;          // mean direct prerequisites per course
+    int layers = 8;                // DAG layers; edges only go to later layers
+    double studentsPerCourse = 2.0;
+    int perStudent = 5;            // mean enrollments per student
+    bool zipf = false;             // skew enrollments toward low course ids
+    unsigned seed = 1;
+    double minMs = 50.0;           // time each op for at least this long
+    int maxReps = 1000;
+    int maxCubic = 2000;
+    int maxMatrix = 20000;
+    vector<int> enrollScales{ 250000, 1000000, 2000000 };
+    string outFile;
+};
+
+static void parseList(const string& val, vector<int>& out) {
+    out.clear();
+    size_t start = 0;
+    while (start <= val.size()) {
+        size_t comma = val.find(',', start);
+        if (comma == string::npos) comma = val.size();
+        if (comma > start) out.push_back(atoi(val.substr(start, comma - start).c_str()));
+        start = comma + 1;
+    }
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& o) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) { cerr << "missing value for " << arg << endl; return false; }
+        string val = argv[++i];
+        if (arg == "--scales") parseList(val, o.scales);
+        else if (arg == "--enroll-scales") parseList(val, o.enrollScales);
+        else if (arg == "--density") o.density = atof(val.c_str());
+        else if (arg == "--layers") o.layers = max(1, atoi(val.c_str()));
+        else if (arg == "--students-per-course") o.studentsPerCourse = atof(val.c_str());
+        else if (arg == "--per-student") o.perStudent = max(0, atoi(val.c_str()));
+        else if (arg == "--dist") o.zipf = (val == "zipf");
+        else if (arg == "--seed") o.seed = static_cast<unsigned>(atoi(val.c_str()));
+        else if (arg == "--min-ms") o.minMs = atof(val.c_str());
+        else if (arg == "--max-reps") o.maxReps = max(1, atoi(val.c_str()));
+        else if (arg == "--max-cubic") o.maxCubic = atoi(val.c_str());
+        else if (arg == "--max-matrix") o.maxMatrix = atoi(val.c_str());
+        else if (arg == "--out") o.outFile = val;
+        else { cerr << "unknown option " << arg << endl; return false; }
+    }
+    return true;
+}
+
+// --------------------------- Synthetic Catalog ---------------------------
+// Random layered DAG: courses are split into layers and every prerequisite
+// goes from an earlier layer to a later one, so the relation is acyclic.
+struct Catalog {
+    CourseManager cm;
+    PeopleManager pm;
+    Relations rel;
+    vector<int> cToF;
+    vector<int> cToR;
+    long long edges = 0;
+};
+
+// withRelations=false leaves the prerequisite graph empty so scales beyond
+// --max-matrix can still exercise courses, people and enrollments
+static void buildCatalog(int n, const BenchOptions& o, Catalog& cat, bool withRelations) {
+    mt19937 rng(o.seed + static_cast<unsigned>(n));
+    for (int i = 0; i < n; ++i) cat.cm.addCourse("C" + to_string(i), "Course" + to_string(i), 3);
+    if (withRelations) cat.rel.ensureSize(n);
+
+    int layers = min(o.layers, n);
+    vector<int> layerOf(n);
+    for (int i = 0; i < n; ++i) layerOf[i] = static_cast<int>(static_cast<long long>(i) * layers / n);
+    vector<int> layerStart(layers + 1, n);
+    for (int i = n - 1; i >= 0; --i) layerStart[layerOf[i]] = i;
+
+    poisson_distribution<int> degree(o.density);
+    for (int b = 0; withRelations && b < n; ++b) {
+        int below = layerStart[layerOf[b]]; // courses in earlier layers are 0..below-1
+        if (below == 0) continue;
+        uniform_int_distribution<int> pick(0, below - 1);
+        int k = min(degree(rng), below);
+        for (int j = 0; j < k; ++j) {
+            int a = pick(rng);
+            if (!cat.rel.getPrereq(a, b)) { cat.rel.addPrereq(a, b); ++cat.edges; }
+        }
+        if (rng() % 4 == 0) cat.rel.addImplication(pick(rng), b);
+    }
+
+    int faculties = max(1, n / 5), rooms = max(1, n / 10);
+    for (int i = 0; i < faculties; ++i) cat.pm.addFaculty("F" + to_string(i));
+    for (int i = 0; i < rooms; ++i) cat.pm.addRoom("R" + to_string(i));
+    cat.cToF.resize(n);
+    cat.cToR.resize(n);
+    for (int c = 0; c < n; ++c) {
+        cat.cToF[c] = static_cast<int>(rng() % faculties);
+        cat.cToR[c] = static_cast<int>(rng() % rooms);
+    }
+
+    int students = max(2, static_cast<int>(n * o.studentsPerCourse));
+    poisson_distribution<int> load(o.perStudent);
+    uniform_int_distribution<int> uniformCourse(0, n - 1);
+    // zipf: inverse-CDF sampling of an approximate 1/x popularity curve
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int s = 0; s < students; ++s) {
+        int id = cat.pm.addStudent("S" + to_string(s));
+        int k = load(rng);
+        for (int j = 0; j < k; ++j) {
+            int c = o.zipf ? min(n - 1, static_cast<int>(pow(static_cast<double>(n), unit(rng))) - 1)
+                : uniformCourse(rng);
+            cat.pm.enroll(id, c);
+        }
+    }
+}
+
+// --------------------------- Timing ---------------------------
+struct Sample {
+    int reps;
+    double meanNs;
+    double minNs;
+};
+
+static volatile size_t sink; // keeps results observable so calls are not elided
+
+template <class F>
+static Sample measure(F f, const BenchOptions& o) {
+    typedef chrono::steady_clock Clock;
+    Sample s{ 0, 0.0, 1e300 };
+    double total = 0.0;
+    while (s.reps < o.maxReps && total < o.minMs * 1e6) {
+        Clock::time_point t0 = Clock::now();
+        sink = sink + f();
+        double ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - t0).count());
+        total += ns;
+        s.minNs = min(s.minNs, ns);
+        ++s.reps;
+    }
+    s.meanNs = total / s.reps;
+    return s;
+}
+
+// --------------------------- Suite ---------------------------
+class BenchSuite {
+public:
+    BenchSuite(const BenchOptions& opts, ostream& csv) : o(opts), out(csv) {}
+
+    void header() {
+        out << "op,courses,students,prereq_edges,enrollments,reps,mean_ns,min_ns,status" << "\n";
+    }
+
+    void runScale(int n) {
+        static const char* const ops[] = { "closurePrereq", "hasPrereqCycle", "Relations::withFixed(cold)",
+            "Scheduling::listOrders", "Induction::checkStrong", "Logic::applyImplications",
+            "Recommender::suggest", "Relations::reducePrereq", "CourseManager::findByCode",
+            "PeopleManager::isEnrolled", "PeopleManager::coursesOf", "SetOps::unionSet",
+            "SetOps::intersection", "SetOps::difference", "SetOps::powerSet", "Consistency::runAllChecks" };
+        if (n <= 0) {
+            for (const char* op : ops) skip(op, n, 0, 0, 0);
+            return;
+        }
+        bool matrix = n <= o.maxMatrix;
+        Catalog cat;
+        buildCatalog(n, o, cat, matrix);
+        int students = static_cast<int>(cat.pm.listStudents().size());
+        long long enrolled = cat.pm.enrollmentCount();
+        bool cubic = matrix && n <= o.maxCubic;
+
+        // completed set: every course of a random student plus the first layer
+        vector<bool> completed(n, false);
+        for (int c : cat.pm.coursesOf(0)) completed[c] = true;
+        for (int c = 0; c < n / max(1, o.layers); ++c) completed[c] = true;
+        int target = n - 1;
+
+        auto row = [&](const char* op, bool run, function<size_t()> f) {
+            if (!run) { skip(op, n, students, cat.edges, enrolled); return; }
+            emit(op, n, students, cat.edges, enrolled, measure(f, o));
+        };
+
+        row("closurePrereq", cubic, [&] { return cat.rel.closurePrereq().size(); });
+        row("hasPrereqCycle", cubic, [&] { return static_cast<size_t>(cat.rel.hasPrereqCycle()); });
+        // toggling an existing edge drops the cached closure, so every rep rebuilds it
+        pair<int, int> edge(-1, -1);
+        for (int a = 0; cubic && edge.first < 0 && a < n; ++a)
+            for (int b = 0; b < n; ++b) if (cat.rel.getPrereq(a, b)) { edge = make_pair(a, b); break; }
+        row("Relations::withFixed(cold)", n <= FixedRelations<4>::Capacity && edge.first >= 0, [&] {
+            cat.rel.removePrereq(edge.first, edge.second);
+            cat.rel.addPrereq(edge.first, edge.second);
+            return static_cast<size_t>(cat.rel.hasPrereqCycle());
+        });
+        row("Scheduling::listOrders", cubic, [&] {
+            Scheduling sched(cat.rel);
+            return sched.listOrders(n, 10).size();
+        });
+        row("Induction::checkStrong", cubic, [&] {
+            Induction ind(cat.rel);
+            return static_cast<size_t>(ind.checkStrong(target, completed));
+        });
+        row("Logic::applyImplications", cubic, [&] {
+            Logic logic(cat.rel);
+            return logic.applyImplications(completed).size();
+        });
+        row("Recommender::suggest", cubic, [&] {
+            Recommender rec(cat.rel, cat.cm);
+            return rec.suggest(completed, 10).size();
+        });
+        row("Relations::reducePrereq", matrix, [&] {
+            vector<pair<int, int>> minimal, redundant;
+            cat.rel.reducePrereq(minimal, redundant);
+            return minimal.size();
+        });
+
+        // hash and CSR lookups scale past --max-matrix; probes cycle through fixed ids
+        vector<string> codes;
+        for (int i = 0; i < 64; ++i) codes.push_back("C" + to_string(static_cast<long long>(i) * 7919 % n));
+        row("CourseManager::findByCode", true, [&] {
+            size_t hits = 0;
+            for (const string& code : codes) hits += cat.cm.findByCode(code) >= 0;
+            return hits;
+        });
+        row("PeopleManager::isEnrolled", true, [&] {
+            size_t hits = 0;
+            for (int i = 0; i < 64; ++i)
+                hits += cat.pm.isEnrolled(static_cast<int>(static_cast<long long>(i) * 7919 % students), i % n);
+            return hits;
+        });
+        row("PeopleManager::coursesOf", true, [&] {
+            size_t total = 0;
+            for (int i = 0; i < 64; ++i)
+                for (int c : cat.pm.coursesOf(static_cast<int>(static_cast<long long>(i) * 7919 % students))) total += c;
+            return total;
+        });
+
+        // the two busiest students give the largest set operands
+        vector<int> a, b;
+        for (int s = 0; s < students; ++s) {
+            vector<int> e = cat.pm.coursesOf(s).toVector();
+            if (e.size() > a.size()) { b.swap(a); a.swap(e); }
+            else if (e.size() > b.size()) b.swap(e);
+        }
+        vector<int> small(a.begin(), a.begin() + min<size_t>(a.size(), 12));
+        row("SetOps::unionSet", true, [&] { return SetOps::unionSet(a, b).size(); });
+        row("SetOps::intersection", true, [&] { return SetOps::intersection(a, b).size(); });
+        row("SetOps::difference", true, [&] { return SetOps::difference(a, b).size(); });
+        row("SetOps::powerSet", true, [&] { return SetOps::powerSet(small).size(); });
+
+        ostream discard(nullptr);
+        row("Consistency::runAllChecks", cubic, [&] {
+            Consistency cons(cat.rel, cat.cm, cat.pm, cat.cToF, cat.cToR);
+            cons.runAllChecks(discard);
+            return static_cast<size_t>(1);
+        });
+    }
+
+    // bulk enrollment at CSR scale; one timed pass, reported per enrollment
+    void runEnrollScale(int total) {
+        const int courses = 200;
+        int students = max(1, total / 5);
+        if (total <= 0) { skip("PeopleManager::enroll", courses, students, 0, 0); return; }
+        PeopleManager pm;
+        for (int s = 0; s < students; ++s) pm.addStudent("S" + to_string(s));
+        mt19937 rng(o.seed + static_cast<unsigned>(total));
+        uniform_int_distribution<int> pickCourse(0, courses - 1), pickStudent(0, students - 1);
+        vector<pair<int, int> > pairs;
+        pairs.reserve(total);
+        for (int i = 0; i < total; ++i) pairs.push_back(make_pair(pickStudent(rng), pickCourse(rng)));
+
+        typedef chrono::steady_clock Clock;
+        Clock::time_point t0 = Clock::now();
+        for (const pair<int, int>& p : pairs) pm.enroll(p.first, p.second);
+        double ns = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - t0).count());
+        Sample s{ 1, ns / total, ns / total };
+        emit("PeopleManager::enroll", courses, students, 0, pm.enrollmentCount(), s);
+    }
+
+private:
+    const BenchOptions& o;
+    ostream& out;
+
+    void emit(const char* op, int n, int students, long long edges, long long enrolled, const Sample& s) {
+        out << op << "," << n << "," << students << "," << edges << "," << enrolled << ","
+            << s.reps << "," << static_cast<long long>(s.meanNs) << "," << static_cast<long long>(s.minNs) << ",ok" << "\n";
+        out.flush();
+    }
+
+    void skip(const char* op, int n, int students, long long edges, long long enrolled) {
+        out << op << "," << n << "," << students << "," << edges << "," << enrolled << ",0,,,skipped" << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    BenchOptions o;
+    if (!parseOptions(argc, argv, o)) return 2;
+    ofstream file;
+    if (!o.outFile.empty()) {
+        file.open(o.outFile.c_str());
+        if (!file.is_open()) { cerr << "Cannot open " << o.outFile << endl; return 2; }
+    }
+    BenchSuite suite(o, o.outFile.empty() ? cout : file);
+    suite.header();
+    for (int n : o.scales) suite.runScale(n);
+    for (int e : o.enrollScales) suite.runEnrollScale(e);
+    return 0;
+}